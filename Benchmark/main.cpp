@@ -0,0 +1,238 @@
+// Runs scripted stress scenarios through World::update with a fixed seed and time step,
+// and writes per-tick mean/p50/p99 of every update phase, as timed by the profiler, as JSON.
+// Usage: Benchmark [output.json] [ticks] [threads] [serial-collisions]; run it from the directory containing the game's assets.
+// Threads default to the hardware's; with 1, entities are updated sequentially. serial-collisions keeps
+// the narrow phase on one thread, to compare its throughput against the parallel one.
+
+#include "World.h"
+#include "Animal.h"
+#include "Pickup.h"
+#include "CommandQueue.h"
+#include "Random.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "Foreach.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+
+
+namespace
+{
+	// Same view and time step as the game
+	const sf::Vector2f		ViewSize(1000.f, 700.f);
+	const sf::Time			TimePerFrame = sf::seconds(1.f/60.f);
+	const sf::Uint64		Seed = 20130901;
+
+	// Far more than a tick's worth of collisions can take, so the player never dies
+	const int				PlayerHitpoints = 1000000;
+
+	struct Scenario
+	{
+		const char*			name;
+		int					frogs;
+		int					pickups;
+		bool				maxFirepower;
+		bool				quackStorm;
+	};
+
+	const Scenario Scenarios[] =
+	{
+		{ "frogs_1k",		1000,	0,		false,	false },
+		{ "frogs_10k",		10000,	0,		false,	false },
+		{ "max_firepower",	1000,	0,		true,	false },
+		{ "quack_storm",	1000,	0,		false,	true  },
+		{ "pickup_flood",	0,		2000,	false,	false },
+	};
+
+	enum Phase
+	{
+		Commands,
+		Collision,
+		WreckRemoval,
+		Spawning,
+		SceneUpdate,
+		Total,
+		PhaseCount
+	};
+
+	const char* PhaseNames[PhaseCount] = { "commands", "collision", "wreck_removal", "spawning", "scene_update", "total" };
+
+	// The profiler's sections for the phases, below World::update; the total is World::update itself
+	const char* SectionNames[PhaseCount] = { "commands", "collision", "wreck removal", "spawning", "scene update", "World::update" };
+
+	struct Summary
+	{
+		double				mean;
+		double				p50;
+		double				p99;
+	};
+
+	Summary summarize(std::vector<sf::Int64> samples)
+	{
+		Summary summary = { 0.0, 0.0, 0.0 };
+		if (samples.empty())
+			return summary;
+
+		std::sort(samples.begin(), samples.end());
+
+		double sum = 0.0;
+		for (std::size_t i = 0; i < samples.size(); ++i)
+			sum += static_cast<double>(samples[i]);
+
+		// Nearest rank percentiles
+		summary.mean = sum / samples.size();
+		summary.p50 = static_cast<double>(samples[(samples.size() - 1) * 50 / 100]);
+		summary.p99 = static_cast<double>(samples[(samples.size() - 1) * 99 / 100]);
+		return summary;
+	}
+
+	sf::Time getPhaseTime(Phase phase)
+	{
+		const std::vector<Profiler::Section>& sections = Profiler::getInstance().getSections();
+
+		// Nothing here opens a scope around World::update, so it's a root section
+		FOREACH(const Profiler::Section& section, sections)
+		{
+			std::size_t expectedDepth = (phase == Total) ? 0 : 1;
+			if (section.depth != expectedDepth || std::strcmp(section.name, SectionNames[phase]) != 0)
+				continue;
+
+			if (phase == Total || std::strcmp(sections[section.parent].name, SectionNames[Total]) == 0)
+				return section.lastFrameTime;
+		}
+
+		throw std::runtime_error(std::string("Benchmark - No profiler section ") + SectionNames[phase] + ", build GameCore with GAME_PROFILING");
+	}
+
+	void populate(World& world, const Scenario& scenario)
+	{
+		Random& random = world.getRandom();
+
+		// Frogs anywhere across the width of the view, from the spawn position up to the end of the level
+		for (int i = 0; i < scenario.frogs; ++i)
+			world.addEnemy(Animal::Frog, random.nextFloat(-450.f, 450.f), random.nextFloat(0.f, 2300.f));
+
+		// Pickups fill the initial view
+		for (int i = 0; i < scenario.pickups; ++i)
+		{
+			auto type = static_cast<Pickup::Type>(random.nextInt(Pickup::TypeCount));
+			world.addPickup(type, random.nextFloat(-450.f, 450.f), random.nextFloat(-300.f, 300.f));
+		}
+
+		if (scenario.maxFirepower)
+		{
+			Command upgrade;
+			upgrade.category = Category::PlayerAnimal;
+			upgrade.action = derivedAction<Animal>([] (Animal& animal, sf::Time)
+			{
+				for (int i = 0; i < 10; ++i)
+				{
+					animal.increaseFireRate();
+					animal.increaseSpread();
+				}
+			});
+
+			world.getCommandQueue().push(upgrade);
+		}
+	}
+
+	void pushPlayerCommands(World& world, const Scenario& scenario)
+	{
+		// The player is kept alive, so every scenario runs for the same number of ticks
+		bool quackStorm = scenario.quackStorm;
+
+		Command act;
+		act.category = Category::PlayerAnimal;
+		act.action = derivedAction<Animal>([quackStorm] (Animal& animal, sf::Time)
+		{
+			if (animal.getHitpoints() < PlayerHitpoints)
+				animal.repair(PlayerHitpoints - animal.getHitpoints());
+
+			animal.fire();
+			if (quackStorm)
+			{
+				animal.collectQuack(1);
+				animal.launchQuack();
+			}
+		});
+
+		world.getCommandQueue().push(act);
+	}
+
+	void run(const Scenario& scenario, int maxTicks, JobSystem* jobs, bool parallelCollisions, std::ostream& json)
+	{
+		AssetCache assets;
+		World world(ViewSize, nullptr, assets, Seed, jobs);
+		world.setParallelCollisions(parallelCollisions);
+		populate(world, scenario);
+
+		std::vector<std::vector<sf::Int64>> samples(PhaseCount);
+		FOREACH(std::vector<sf::Int64>& phaseSamples, samples)
+			phaseSamples.reserve(maxTicks);
+
+		int tick = 0;
+		for (; tick < maxTicks && !world.hasPlayerReachedEnd(); ++tick)
+		{
+			pushPlayerCommands(world, scenario);
+			world.update(TimePerFrame);
+
+			// Every tick is a profiler frame of its own
+			Profiler::getInstance().nextFrame();
+			for (int phase = 0; phase < PhaseCount; ++phase)
+				samples[phase].push_back(getPhaseTime(static_cast<Phase>(phase)).asMicroseconds());
+		}
+
+		json << "\t\t{\n\t\t\t\"name\": \"" << scenario.name << "\",\n\t\t\t\"ticks\": " << tick << ",\n\t\t\t\"phases\": {\n";
+		for (int phase = 0; phase < PhaseCount; ++phase)
+		{
+			Summary summary = summarize(samples[phase]);
+			json << "\t\t\t\t\"" << PhaseNames[phase] << "\": { \"mean\": " << summary.mean << ", \"p50\": " << summary.p50 << ", \"p99\": " << summary.p99 << " }"
+				<< (phase + 1 < PhaseCount ? ",\n" : "\n");
+
+			if (phase == Total)
+				std::cout << scenario.name << ": " << tick << " ticks, mean " << summary.mean << " us, p50 " << summary.p50 << " us, p99 " << summary.p99 << " us" << std::endl;
+		}
+		json << "\t\t\t}\n\t\t}";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		std::string filename = (argc > 1) ? argv[1] : "benchmark.json";
+		int maxTicks = (argc > 2) ? std::atoi(argv[2]) : 3600;
+		int threads = (argc > 3) ? std::atoi(argv[3]) : static_cast<int>(JobSystem::getHardwareThreadCount());
+		bool parallelCollisions = !(argc > 4 && std::string(argv[4]) == "serial-collisions");
+
+		// The calling thread runs jobs too
+		JobSystem jobs(static_cast<std::size_t>(std::max(threads, 1) - 1));
+
+		std::ofstream json(filename.c_str());
+		if (!json)
+			throw std::runtime_error("Benchmark - Failed to open " + filename);
+
+		json << "{\n\t\"seed\": " << Seed << ",\n\t\"threads\": " << jobs.getThreadCount() << ",\n\t\"parallelCollisions\": " << (parallelCollisions ? "true" : "false") << ",\n\t\"timePerFrame\": " << TimePerFrame.asSeconds() << ",\n\t\"unit\": \"us\",\n\t\"scenarios\": [\n";
+
+		const std::size_t scenarioCount = sizeof(Scenarios) / sizeof(Scenarios[0]);
+		for (std::size_t i = 0; i < scenarioCount; ++i)
+		{
+			run(Scenarios[i], maxTicks, threads > 1 ? &jobs : nullptr, parallelCollisions, json);
+			json << (i + 1 < scenarioCount ? ",\n" : "\n");
+		}
+
+		json << "\t]\n}\n";
+	}
+	catch (std::exception& e)
+	{
+		std::cout << "\nEXCEPTION: " << e.what() << std::endl;
+		return 1;
+	}
+}
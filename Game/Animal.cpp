@@ -1,10 +1,13 @@
 #include "Animal.h"
-#include "ResourceHolder.h"
+#include "resourceHolder.h"
+#include "TextureAtlas.h"
 #include "DataTables.h"
 #include "Utility.h"
+#include "Random.h"
 #include "Pickup.h"
 #include "CommandQueue.h"
 #include "SpriteNode.h"
+#include "SpriteBatch.h"
 
 
 #include <SFML/Graphics/RenderTarget.hpp>
@@ -20,8 +23,8 @@ namespace
 
 
 
-Animal::Animal(Type type, const TextureHolder& textures, const FontHolder& fonts)
-: Entity(Table[type].hitpoints)
+Animal::Animal(HandleTable& handles, Type type, const TextureAtlas& textures, const FontHolder* fonts, Random& random)
+: Entity(handles, Table[type].hitpoints)
 , mType(type)
 , mFireCommand()
 , mQuackCommand()
@@ -29,44 +32,58 @@ Animal::Animal(Type type, const TextureHolder& textures, const FontHolder& fonts
 , mIsFiring(false)
 , mIsLaunchingQuack(false)
 , mIsMarkedForRemoval(false)
-, mSprite(textures.get(Table[type].texture))
+, mSprite(textures.createSprite(Table[type].texture))
 , mFireRateLevel(1)
 , mSpreadLevel(1)
 , mQuackAmmo(2)
 , mDropPickupCommand()
 , mTravelledDistance(0.f)
 , mDirectionIndex(0)
-, mQuackDisplay(nullptr)
+, mHealthDisplay()
+, mQuackDisplay()
+, mDisplayedHitpoints(-1)
+, mDisplayedQuackAmmo(-1)
+, mRandom(random)
 {
 	centerOrigin(mSprite);
 
-	mFireCommand.category = Category::SceneAirLayer;
-	mFireCommand.action   = [this, &textures] (SceneNode& node, sf::Time)
+	// Commands refer to the animal through a handle; if it is gone by the time they execute, they do nothing
+	Handle<Animal> self(*this);
+
+	mFireCommand.category = Category::ProjectileSystem;
+	mFireCommand.action   = derivedAction<ProjectileSystem>([self] (ProjectileSystem& projectiles, sf::Time)
 	{
-		createLasers(node, textures);
-	};
+		if (Animal* animal = self.get())
+			animal->createLasers(projectiles);
+	});
 
-	mQuackCommand.category = Category::SceneAirLayer;
-	mQuackCommand.action   = [this, &textures] (SceneNode& node, sf::Time)
+	mQuackCommand.category = Category::ProjectileSystem;
+	mQuackCommand.action   = derivedAction<ProjectileSystem>([self] (ProjectileSystem& projectiles, sf::Time)
 	{
-		createProjectile(node, Projectile::Quack, 0.f, 0.5f, textures);
-	};
+		if (Animal* animal = self.get())
+			animal->createProjectile(projectiles, ProjectileSystem::Quack, 0.f, 0.5f);
+	});
 
 	mDropPickupCommand.category = Category::SceneAirLayer;
-	mDropPickupCommand.action   = [this, &textures] (SceneNode& node, sf::Time)
+	mDropPickupCommand.action   = [self, &textures] (SceneNode& node, sf::Time)
 	{
-		createPickup(node, textures);
+		if (Animal* animal = self.get())
+			animal->createPickup(node, textures);
 	};
 
-	std::unique_ptr<TextNode> healthDisplay(new TextNode(fonts, ""));
-	mHealthDisplay = healthDisplay.get();
-	attachChild(std::move(healthDisplay));
+	// Labels are only created when there are fonts to show them, i.e. not in headless runs
+	if (fonts)
+	{
+		std::unique_ptr<TextNode> healthDisplay(new TextNode(handles, *fonts, ""));
+		mHealthDisplay = Handle<TextNode>(*healthDisplay);
+		attachChild(std::move(healthDisplay));
+	}
 
-	if (getCategory() == Category::PlayerAnimal)
+	if (fonts && getCategory() == Category::PlayerAnimal)
 	{
-		std::unique_ptr<TextNode> QuackDisplay(new TextNode(fonts, ""));
+		std::unique_ptr<TextNode> QuackDisplay(new TextNode(handles, *fonts, ""));
 		QuackDisplay->setPosition(0, 30);
-		mQuackDisplay = QuackDisplay.get();
+		mQuackDisplay = Handle<TextNode>(*QuackDisplay);
 		attachChild(std::move(QuackDisplay));
 	}
 
@@ -79,6 +96,11 @@ void Animal::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) cons
 	target.draw(mSprite, states);
 }
 
+void Animal::batchCurrent(SpriteBatch& batch) const
+{
+	batch.addSprite(mSprite, getRenderTransform(batch.getInterpolation()));
+}
+
 void Animal::updateCurrent(sf::Time dt, CommandQueue& commands)
 {
 	// Entity has been destroyed: Possibly drop pickup, mark for removal
@@ -110,7 +132,7 @@ unsigned int Animal::getCategory() const
 	
 }
 
-sf::FloatRect Animal::getBoundingRect() const
+sf::FloatRect Animal::computeBoundingRect() const
 {
 	return getWorldTransform().transformRect(mSprite.getGlobalBounds());
 }
@@ -170,7 +192,8 @@ void Animal::updateMovementPattern(sf::Time dt)
 
 void Animal::checkPickupDrop(CommandQueue& commands)
 {
-	if (!isAllied() && randomInt(3) == 0)
+	// The chance is rolled when the command executes, so updates never touch the shared random generator
+	if (!isAllied())
 		commands.push(mDropPickupCommand);
 }
 
@@ -203,47 +226,47 @@ void Animal::checkProjectileLaunch(sf::Time dt, CommandQueue& commands)
 	}
 }
 
-void Animal::createLasers(SceneNode& node, const TextureHolder& textures) const
+void Animal::createLasers(ProjectileSystem& projectiles) const
 {
-	Projectile::Type type = isAllied() ? Projectile::AlliedLaser : Projectile::EnemyLaser;
+	ProjectileSystem::Type type = isAllied() ? ProjectileSystem::AlliedLaser : ProjectileSystem::EnemyLaser;
 
 	switch (mSpreadLevel)
 	{
 		case 1:
-			createProjectile(node, type, 0.0f, 0.5f, textures);
+			createProjectile(projectiles, type, 0.0f, 0.5f);
 			break;
 
 		case 2:
-			createProjectile(node, type, -0.33f, 0.33f, textures);
-			createProjectile(node, type, +0.33f, 0.33f, textures);
+			createProjectile(projectiles, type, -0.33f, 0.33f);
+			createProjectile(projectiles, type, +0.33f, 0.33f);
 			break;
 
 		case 3:
-			createProjectile(node, type, -0.5f, 0.33f, textures);
-			createProjectile(node, type,  0.0f, 0.5f, textures);
-			createProjectile(node, type, +0.5f, 0.33f, textures);
+			createProjectile(projectiles, type, -0.5f, 0.33f);
+			createProjectile(projectiles, type,  0.0f, 0.5f);
+			createProjectile(projectiles, type, +0.5f, 0.33f);
 			break;
 	}
 }
 
-void Animal::createProjectile(SceneNode& node, Projectile::Type type, float xOffset, float yOffset, const TextureHolder& textures) const
+void Animal::createProjectile(ProjectileSystem& projectiles, ProjectileSystem::Type type, float xOffset, float yOffset) const
 {
-	std::unique_ptr<Projectile> projectile(new Projectile(type, textures));
-
 	sf::Vector2f offset(xOffset * mSprite.getGlobalBounds().width, yOffset * mSprite.getGlobalBounds().height);
-	sf::Vector2f velocity(0, projectile->getMaxSpeed());
+	sf::Vector2f velocity(0, ProjectileSystem::getMaxSpeed(type));
 
 	float sign = isAllied() ? -1.f : +1.f;
-	projectile->setPosition(getWorldPosition() + offset * sign);
-	projectile->setVelocity(velocity * sign);
-	node.attachChild(std::move(projectile));
+	projectiles.addProjectile(type, getWorldPosition() + offset * sign, velocity * sign);
 }
 
-void Animal::createPickup(SceneNode& node, const TextureHolder& textures) const
+void Animal::createPickup(SceneNode& node, const TextureAtlas& textures) const
 {
-	auto type = static_cast<Pickup::Type>(randomInt(Pickup::TypeCount));
+	// One in three destroyed enemies drops a pickup
+	if (mRandom.nextInt(3) != 0)
+		return;
 
-	std::unique_ptr<Pickup> pickup(new Pickup(type, textures));
+	auto type = static_cast<Pickup::Type>(mRandom.nextInt(Pickup::TypeCount));
+
+	std::unique_ptr<Pickup> pickup(new Pickup(getHandleTable(), type, textures));
 	pickup->setPosition(getWorldPosition());
 	pickup->setVelocity(0.f, 1.f);
 	node.attachChild(std::move(pickup));
@@ -251,15 +274,27 @@ void Animal::createPickup(SceneNode& node, const TextureHolder& textures) const
 
 void Animal::updateTexts()
 {
-	mHealthDisplay->setString(toString(getHitpoints()) + " HP");
-	mHealthDisplay->setRotation(-getRotation());
-	mHealthDisplay->setPosition(0.f, 50.f);
+	TextNode* healthDisplay = mHealthDisplay.get();
+	if (healthDisplay)
+	{
+		// Only format the strings when the values change
+		if (getHitpoints() != mDisplayedHitpoints)
+		{
+			mDisplayedHitpoints = getHitpoints();
+			healthDisplay->setString(toString(mDisplayedHitpoints) + " HP");
+		}
+
+		healthDisplay->setRotation(-getRotation());
+		healthDisplay->setPosition(0.f, 50.f);
+	}
 
-	if (mQuackDisplay)
+	TextNode* quackDisplay = mQuackDisplay.get();
+	if (quackDisplay && mQuackAmmo != mDisplayedQuackAmmo)
 	{
+		mDisplayedQuackAmmo = mQuackAmmo;
 		if (mQuackAmmo == 0)
-			mQuackDisplay->setString("");
+			quackDisplay->setString("");
 		else
-			mQuackDisplay->setString("QUACKS: " + toString(mQuackAmmo));
+			quackDisplay->setString("QUACKS: " + toString(mQuackAmmo));
 	}
 }
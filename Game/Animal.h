@@ -2,14 +2,18 @@
 #define H_Animal
 
 #include "Entity.h"
-#include "ResourceIdentifiers.h"
+#include "resourceIdentifiers.h"
 #include "Command.h"
-#include "Projectile.h"
+#include "ProjectileSystem.h"
 #include "TextNode.h"
+#include "Handle.h"
 
 #include <SFML/Graphics/Sprite.hpp>
 
 
+class Random;
+
+
 class Animal : public Entity
 {
 	public:
@@ -23,13 +27,13 @@ class Animal : public Entity
 
 
 	public:
-							Animal(Type type, const TextureHolder& textures, const FontHolder& fonts);
+							Animal(HandleTable& handles, Type type, const TextureAtlas& textures, const FontHolder* fonts, Random& random);
 
 		virtual void		drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+		virtual void		batchCurrent(SpriteBatch& batch) const;
 		virtual void 			updateCurrent(sf::Time dt, CommandQueue& commands);
 		virtual unsigned int	getCategory() const;
 
-		virtual sf::FloatRect	getBoundingRect() const;
 		virtual bool 			isMarkedForRemoval() const;
 		bool					isAllied() const;
 		float					getMaxSpeed() const;
@@ -42,14 +46,18 @@ class Animal : public Entity
 		void					launchQuack();
 
 
+	protected:
+		virtual sf::FloatRect	computeBoundingRect() const;
+
+
 	private:
 		void					updateMovementPattern(sf::Time dt);
 		void					checkPickupDrop(CommandQueue& commands);
 		void					checkProjectileLaunch(sf::Time dt, CommandQueue& commands);
 
-		void					createLasers(SceneNode& node, const TextureHolder& textures) const;
-		void					createProjectile(SceneNode& node, Projectile::Type type, float xOffset, float yOffset, const TextureHolder& textures) const;
-		void					createPickup(SceneNode& node, const TextureHolder& textures) const;
+		void					createLasers(ProjectileSystem& projectiles) const;
+		void					createProjectile(ProjectileSystem& projectiles, ProjectileSystem::Type type, float xOffset, float yOffset) const;
+		void					createPickup(SceneNode& node, const TextureAtlas& textures) const;
 
 		void					updateTexts();
 
@@ -72,8 +80,11 @@ class Animal : public Entity
 		Command 				mDropPickupCommand;
 		float					mTravelledDistance;
 		std::size_t				mDirectionIndex;
-		TextNode*				mHealthDisplay;
-		TextNode*				mQuackDisplay;
+		Handle<TextNode>		mHealthDisplay;
+		Handle<TextNode>		mQuackDisplay;
+		int						mDisplayedHitpoints;
+		int						mDisplayedQuackAmmo;
+		Random&					mRandom;
 };
 
 #endif 
@@ -7,29 +7,59 @@
 #include "MenuState.h"
 #include "PauseState.h"
 #include "GameOverState.h"
+#include "LoadingState.h"
+#include "Profiler.h"
+
+#include <SFML/Graphics/Font.hpp>
+
+#include <algorithm>
+#include <iostream>
 
 
 
 const sf::Time Application::TimePerFrame = sf::seconds(1.f/60.f);
+const std::size_t Application::MaxStepsPerFrame = 5;
+
+namespace
+{
+	// Every character size the states, the labels and the profiler overlay use
+	const unsigned int TextSizes[] = { 16, 20, 30, 50, 60, 70, 100 };
+
+	void prebakeGlyphs(const sf::Font& font)
+	{
+		for (std::size_t i = 0; i < sizeof(TextSizes) / sizeof(TextSizes[0]); ++i)
+		{
+			for (sf::Uint32 character = ' '; character <= '~'; ++character)
+				font.getGlyph(character, TextSizes[i], false);
+		}
+	}
+}
 
 Application::Application()
 : mWindow(sf::VideoMode(1000, 700), "Duck Rescue", sf::Style::Close)
-, mTextures()
-, mFonts()
+, mAssets()
 , mPlayer()
-, mStateStack(State::Context(mWindow, mTextures, mFonts, mPlayer))
-, mStatisticsText()
-, mStatisticsUpdateTime()
-, mStatisticsNumFrames(0)
+, mJobs(JobSystem::getHardwareThreadCount() - 1)
+, mStateStack(State::Context(mWindow, mAssets, mPlayer, mJobs))
+, mProfilerOverlay()
+, mInterpolateRendering(true)
+, mTracingToggleRequested(false)
+, mFrame()
+, mRenderThread(mWindow)
+, mRenderThreadEnabled(false)
 {
 	mWindow.setKeyRepeatEnabled(false);
 
-	mFonts.load(Fonts::Main, "ostrich-bold.ttf");
-	mTextures.load(Textures::TitleScreen, "title.png");
+	mAssets.getFonts().load(Fonts::Main, "ostrich-bold.ttf");
+	mAssets.getTextures().load(Textures::TitleScreen, "title.png");
 
-	mStatisticsText.setFont(mFonts.get(Fonts::Main));
-	mStatisticsText.setPosition(5.f, 5.f);
-	mStatisticsText.setCharacterSize(20u);
+	mProfilerOverlay.setFont(mAssets.getFonts().get(Fonts::Main));
+
+	// Popped states free their resources, frames still waiting for the render thread may use them
+	mStateStack.setBeforeChangeCallback([this] ()
+	{
+		mRenderThread.finishFrames();
+	});
 
 	registerStates();
 	mStateStack.pushState(States::Title);
@@ -40,73 +70,166 @@ void Application::run()
 	sf::Clock clock;
 	sf::Time timeSinceLastUpdate = sf::Time::Zero;
 
+	if (mRenderThreadEnabled)
+	{
+		// From now on the font's glyph textures must not change, the render thread draws with them
+		prebakeGlyphs(mAssets.getFonts().get(Fonts::Main));
+		mRenderThread.start();
+	}
+
 	while (mWindow.isOpen())
 	{
+		Profiler::getInstance().nextFrame();
+
 		sf::Time dt = clock.restart();
 		timeSinceLastUpdate += dt;
-		while (timeSinceLastUpdate > TimePerFrame)
+
 		{
-			timeSinceLastUpdate -= TimePerFrame;
+			PROFILE_SCOPE("Application::fixedSteps");
+
+			std::size_t steps = 0;
+			while (timeSinceLastUpdate > TimePerFrame && steps < MaxStepsPerFrame)
+			{
+				PROFILE_SCOPE("tick");
+				timeSinceLastUpdate -= TimePerFrame;
+				++steps;
+
+				processInput();
+				update(TimePerFrame);
+
+				// Check inside this loop, because stack might be empty before update() call
+				if (mStateStack.isEmpty())
+					closeWindow();
+			}
+
+			// After a stall (window drag, loading), the time that couldn't be caught up is dropped,
+			// so the game slows down instead of falling further behind with every frame
+			timeSinceLastUpdate = std::min(timeSinceLastUpdate, TimePerFrame);
+		}
 
-			processInput();
-			update(TimePerFrame);
+		mProfilerOverlay.update(dt);
 
-			// Check inside this loop, because stack might be empty before update() call
-			if (mStateStack.isEmpty())
-				mWindow.close();
-		}
+		// Draw the state in between the last two updates, the leftover time decides where
+		float alpha = mInterpolateRendering ? timeSinceLastUpdate.asSeconds() / TimePerFrame.asSeconds() : 1.f;
+		render(alpha);
 
-		updateStatistics(dt);
-		render();
+		// Outside of every scope, so writing the trace doesn't show up in it
+		if (mTracingToggleRequested)
+		{
+			mTracingToggleRequested = false;
+			toggleTracing();
+		}
 	}
+
+	// Don't lose a trace that is still being recorded
+	if (Profiler::getInstance().isTracing())
+		toggleTracing();
+}
+
+void Application::recordInput(const std::string& filename)
+{
+	mPlayer.recordTo(filename);
+}
+
+bool Application::replayInput(const std::string& filename)
+{
+	return mPlayer.replayFrom(filename);
+}
+
+void Application::enableRenderThread()
+{
+	mRenderThreadEnabled = true;
 }
 
 void Application::processInput()
 {
+	PROFILE_SCOPE("Application::processInput");
+
 	sf::Event event;
 	while (mWindow.pollEvent(event))
 	{
 		mStateStack.handleEvent(event);
 
 		if (event.type == sf::Event::Closed)
-			mWindow.close();
+			closeWindow();
+
+		// F10 toggles interpolated rendering, F11 starts tracing, pressing it again writes the trace at the end of the frame
+		if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F10)
+			mInterpolateRendering = !mInterpolateRendering;
+
+		if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F11)
+			mTracingToggleRequested = true;
 	}
 }
 
 void Application::update(sf::Time dt)
 {
+	// Background loads are finished here, on the thread with the GL context
+	mAssets.updateLoading();
+
 	mStateStack.update(dt);
 }
 
-void Application::render()
+void Application::render(float alpha)
 {
-	mWindow.clear();
+	bool threaded = mRenderThread.isRunning();
+	FrameSnapshot& frame = threaded ? mRenderThread.getRecordingFrame() : mFrame;
 
-	mStateStack.draw();
+	{
+		PROFILE_SCOPE("Application::render");
+
+		frame.clear();
+		mStateStack.draw(frame, alpha);
 
-	mWindow.setView(mWindow.getDefaultView());
-	mWindow.draw(mStatisticsText);
+		frame.setView(mWindow.getDefaultView());
+		mProfilerOverlay.draw(frame);
+	}
 
+	// The render thread draws and presents the frame while the next one is simulated
+	if (threaded)
+	{
+		mRenderThread.publishFrame();
+		return;
+	}
+
+	{
+		PROFILE_SCOPE("Application::draw");
+
+		mWindow.clear();
+		mWindow.draw(frame);
+	}
+
+	// Includes waiting for vertical sync and the driver, if any
+	PROFILE_SCOPE("RenderWindow::display");
 	mWindow.display();
 }
 
-void Application::updateStatistics(sf::Time dt)
+void Application::closeWindow()
 {
-	mStatisticsUpdateTime += dt;
-	mStatisticsNumFrames += 1;
-	if (mStatisticsUpdateTime >= sf::seconds(1.0f))
-	{
-		mStatisticsText.setString("FPS: " + toString(mStatisticsNumFrames));
+	// The render thread has to release the window first
+	mRenderThread.stop();
+	mWindow.close();
+}
 
-		mStatisticsUpdateTime -= sf::seconds(1.0f);
-		mStatisticsNumFrames = 0;
+void Application::toggleTracing()
+{
+	Profiler& profiler = Profiler::getInstance();
+	if (!profiler.isTracing())
+	{
+		profiler.setTracing(true);
+		return;
 	}
+
+	profiler.setTracing(false);
+	if (!profiler.writeTrace("trace.json"))
+		std::cout << "Failed to write trace.json" << std::endl;
 }
 
 void Application::registerStates()
 {
 	mStateStack.registerState<TitleState>(States::Title);
 	mStateStack.registerState<MenuState>(States::Menu);
+	mStateStack.registerState<LoadingState>(States::Loading);
 	mStateStack.registerState<GameState>(States::Game);	
 	mStateStack.registerState<PauseState>(States::Pause);
 	mStateStack.registerState<GameOverState>(States::GameOver);
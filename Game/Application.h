@@ -1,14 +1,19 @@
 #ifndef H_APPLICATION
 #define H_APPLICATION
 
-#include "resourceHolder.h"
-#include "ResourceIdentifiers.h"
+#include "AssetCache.h"
+#include "resourceIdentifiers.h"
 #include "Player.h"
 #include "StateStack.h"
+#include "ProfilerOverlay.h"
+#include "FrameSnapshot.h"
+#include "RenderThread.h"
+#include "JobSystem.h"
 
 #include <SFML/System/Time.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
-#include <SFML/Graphics/Text.hpp>
+
+#include <string>
 
 
 class Application
@@ -16,30 +21,44 @@ class Application
 	public:
 								Application();
 		void					run();
+
+		// Record the player's input to a file, or replay it from one
+		void					recordInput(const std::string& filename);
+		bool					replayInput(const std::string& filename);
+
+		// Draw and present on a separate thread, overlapping with the simulation
+		void					enableRenderThread();
 		
 
 	private:
 		void					processInput();
 		void					update(sf::Time dt);
-		void					render();
+		void					render(float alpha);
+
+		void					toggleTracing();
+		void					closeWindow();
 
-		void					updateStatistics(sf::Time dt);
 		void					registerStates();
 
 
 	private:
 		static const sf::Time	TimePerFrame;
+		static const std::size_t	MaxStepsPerFrame;
 
 		sf::RenderWindow		mWindow;
-		TextureHolder			mTextures;
-	  	FontHolder				mFonts;
+		AssetCache				mAssets;
 		Player					mPlayer;
+		JobSystem				mJobs;
 
 		StateStack				mStateStack;
 
-		sf::Text				mStatisticsText;
-		sf::Time				mStatisticsUpdateTime;
-		std::size_t				mStatisticsNumFrames;
+		ProfilerOverlay			mProfilerOverlay;
+		bool					mInterpolateRendering;
+		bool					mTracingToggleRequested;
+
+		FrameSnapshot			mFrame;
+		RenderThread			mRenderThread;
+		bool					mRenderThreadEnabled;
 };
 
 #endif 
@@ -0,0 +1,29 @@
+#include "AssetCache.h"
+
+
+TextureHolder& AssetCache::getTextures()
+{
+	return mTextures;
+}
+
+ImageHolder& AssetCache::getImages()
+{
+	return mImages;
+}
+
+FontHolder& AssetCache::getFonts()
+{
+	return mFonts;
+}
+
+AtlasHolder& AssetCache::getAtlases()
+{
+	return mAtlases;
+}
+
+void AssetCache::updateLoading()
+{
+	mTextures.updateLoading();
+	mImages.updateLoading();
+	mFonts.updateLoading();
+}
@@ -0,0 +1,37 @@
+#ifndef H_ASSETCACHE
+#define H_ASSETCACHE
+
+#include "resourceHolder.h"
+#include "resourceIdentifiers.h"
+#include "TextureAtlas.h"
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Font.hpp>
+
+
+// Everything the game loads from disk, in one place for the whole process. States and worlds
+// share it through State::Context instead of keeping holders of their own, so switching states
+// or restarting a level doesn't read a file or upload a texture twice. Users count their
+// references with acquire() and release() on the holders; retained assets outlive the last one.
+class AssetCache : private sf::NonCopyable
+{
+	public:
+		TextureHolder&				getTextures();
+		ImageHolder&				getImages();
+		FontHolder&					getFonts();
+		AtlasHolder&				getAtlases();
+
+		// Adds what was loaded in the background; call it on the thread with the GL context
+		void						updateLoading();
+
+
+	private:
+		TextureHolder				mTextures;
+		ImageHolder					mImages;
+		FontHolder					mFonts;
+		AtlasHolder					mAtlases;
+};
+
+#endif
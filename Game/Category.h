@@ -13,11 +13,10 @@ namespace Category
 		AlliedAnimal		= 1 << 2,
 		EnemyAnimal			= 1 << 3,
 		Pickup				= 1 << 4,
-		AlliedProjectile	= 1 << 5,
-		EnemyProjectile		= 1 << 6,
+		ProjectileSystem	= 1 << 5,
 
 		Animal = PlayerAnimal | AlliedAnimal | EnemyAnimal,
-		Projectile = AlliedProjectile | EnemyProjectile,
+		Collidable = Animal | Pickup,
 	};
 }
 
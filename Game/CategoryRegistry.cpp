@@ -0,0 +1,125 @@
+#include "CategoryRegistry.h"
+#include "SceneNode.h"
+#include "Command.h"
+#include "CollisionGrid.h"
+
+#include <cassert>
+
+
+CategoryRegistry::CategoryRegistry()
+: mLists(BitCount)
+, mGrid(nullptr)
+{
+	for (std::size_t i = 0; i < mLists.size(); ++i)
+	{
+		mLists[i].first = nullptr;
+		mLists[i].last = nullptr;
+		mLists[i].size = 0;
+	}
+}
+
+void CategoryRegistry::setCollisionGrid(CollisionGrid* grid)
+{
+	mGrid = grid;
+}
+
+void CategoryRegistry::add(SceneNode& node)
+{
+	assert(node.mRegisteredBit < 0);
+
+	// Nodes without category never receive commands
+	unsigned int category = node.getCategory();
+	if (category == 0u)
+		return;
+
+	std::size_t bit = bitIndex(category);
+	List& list = mLists[bit];
+
+	// Append, so dispatch order follows attach order
+	node.mRegisteredBit = static_cast<int>(bit);
+	node.mPrevInCategory = list.last;
+	node.mNextInCategory = nullptr;
+
+	if (list.last)
+		list.last->mNextInCategory = &node;
+	else
+		list.first = &node;
+
+	list.last = &node;
+	++list.size;
+
+	// Only entities take part in collisions and spatial queries; layers, sprites and texts are skipped
+	if (mGrid && (category & Category::Collidable))
+		mGrid->insert(node);
+}
+
+void CategoryRegistry::remove(SceneNode& node)
+{
+	if (node.mRegisteredBit < 0)
+		return;
+
+	if (mGrid)
+		mGrid->remove(node);
+
+	List& list = mLists[node.mRegisteredBit];
+
+	if (node.mPrevInCategory)
+		node.mPrevInCategory->mNextInCategory = node.mNextInCategory;
+	else
+		list.first = node.mNextInCategory;
+
+	if (node.mNextInCategory)
+		node.mNextInCategory->mPrevInCategory = node.mPrevInCategory;
+	else
+		list.last = node.mPrevInCategory;
+
+	--list.size;
+
+	node.mRegisteredBit = -1;
+	node.mPrevInCategory = nullptr;
+	node.mNextInCategory = nullptr;
+}
+
+void CategoryRegistry::onCommand(const Command& command, sf::Time dt)
+{
+	for (std::size_t bit = 0; bit < BitCount; ++bit)
+	{
+		if (!(command.category & (1u << bit)))
+			continue;
+
+		// Fetch the successor first, in case the action detaches the node
+		for (SceneNode* node = mLists[bit].first; node != nullptr; )
+		{
+			SceneNode* next = node->mNextInCategory;
+			command.action(*node, dt);
+			node = next;
+		}
+	}
+}
+
+std::size_t CategoryRegistry::getCount(unsigned int category) const
+{
+	std::size_t count = 0;
+	for (std::size_t bit = 0; bit < BitCount; ++bit)
+	{
+		if (category & (1u << bit))
+			count += mLists[bit].size;
+	}
+
+	return count;
+}
+
+std::size_t CategoryRegistry::bitIndex(unsigned int category)
+{
+	// Registered nodes carry exactly one category bit
+	assert((category & (category - 1)) == 0);
+
+	std::size_t index = 0;
+	while (!(category & 1u))
+	{
+		category >>= 1;
+		++index;
+	}
+
+	return index;
+}
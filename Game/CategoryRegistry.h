@@ -0,0 +1,51 @@
+#ifndef H_CATEGORYREGISTRY
+#define H_CATEGORYREGISTRY
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Time.hpp>
+
+#include <vector>
+
+
+class SceneNode;
+class CollisionGrid;
+struct Command;
+
+// Keeps every attached node with a category in an intrusive list per category bit,
+// so commands only visit the nodes they are addressed to.
+// Collidable nodes are also forwarded to the collision grid, if one is set.
+class CategoryRegistry : private sf::NonCopyable
+{
+	public:
+									CategoryRegistry();
+
+		void						setCollisionGrid(CollisionGrid* grid);
+
+		void						add(SceneNode& node);
+		void						remove(SceneNode& node);
+
+		void						onCommand(const Command& command, sf::Time dt);
+		std::size_t					getCount(unsigned int category) const;
+
+
+	private:
+		struct List
+		{
+			SceneNode*				first;
+			SceneNode*				last;
+			std::size_t				size;
+		};
+
+		static const std::size_t	BitCount = 32;
+
+
+	private:
+		static std::size_t			bitIndex(unsigned int category);
+
+
+	private:
+		std::vector<List>			mLists;
+		CollisionGrid*				mGrid;
+};
+
+#endif
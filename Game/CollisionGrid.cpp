@@ -0,0 +1,520 @@
+#include "CollisionGrid.h"
+#include "Foreach.h"
+#include "Utility.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+#include <limits>
+
+
+namespace
+{
+	const float Infinity = std::numeric_limits<float>::infinity();
+
+	bool nodePrecedes(const SceneNode* lhs, const SceneNode* rhs)
+	{
+		return lhs->getCreationSequence() < rhs->getCreationSequence();
+	}
+
+	SceneNode::Pair makePair(SceneNode* lhs, SceneNode* rhs)
+	{
+		return nodePrecedes(lhs, rhs) ? SceneNode::Pair(lhs, rhs) : SceneNode::Pair(rhs, lhs);
+	}
+
+	bool pairPrecedes(const SceneNode::Pair& lhs, const SceneNode::Pair& rhs)
+	{
+		if (lhs.first != rhs.first)
+			return nodePrecedes(lhs.first, rhs.first);
+
+		return nodePrecedes(lhs.second, rhs.second);
+	}
+
+	// Clips the ray parameter interval [tMin, tMax] against one slab of a rectangle
+	bool clipSlab(float origin, float direction, float slabMin, float slabMax, float& tMin, float& tMax)
+	{
+		if (direction == 0.f)
+			return origin >= slabMin && origin <= slabMax;
+
+		float t1 = (slabMin - origin) / direction;
+		float t2 = (slabMax - origin) / direction;
+		tMin = std::max(tMin, std::min(t1, t2));
+		tMax = std::min(tMax, std::max(t1, t2));
+
+		return tMin <= tMax;
+	}
+
+	bool intersectsRay(const sf::FloatRect& rect, sf::Vector2f origin, sf::Vector2f direction, float& distance)
+	{
+		float tMin = 0.f;
+		float tMax = Infinity;
+
+		if (!clipSlab(origin.x, direction.x, rect.left, rect.left + rect.width, tMin, tMax)
+		 || !clipSlab(origin.y, direction.y, rect.top, rect.top + rect.height, tMin, tMax))
+			return false;
+
+		distance = tMin;
+		return true;
+	}
+}
+
+CollisionGrid::CollisionGrid(float cellSize, const CollisionMatrix& matrix)
+: mCellSize(cellSize)
+, mMatrix(matrix)
+, mBounds()
+, mColumns(0)
+, mRows(0)
+, mEntries()
+, mCells()
+, mJobPairs()
+{
+	assert(cellSize > 0.f);
+}
+
+void CollisionGrid::reset(sf::FloatRect bounds)
+{
+	mBounds = bounds;
+	mColumns = std::max(1, static_cast<int>(std::ceil(bounds.width / mCellSize)));
+	mRows = std::max(1, static_cast<int>(std::ceil(bounds.height / mCellSize)));
+
+	mCells.resize(mColumns * mRows);
+	FOREACH(std::vector<std::size_t>& cell, mCells)
+		cell.clear();
+
+	// Nodes already in the grid are bucketed again for the new layout
+	for (std::size_t i = 0; i < mEntries.size(); ++i)
+	{
+		computeCellRange(mEntries[i]);
+		addToCells(i);
+	}
+}
+
+void CollisionGrid::insert(SceneNode& node)
+{
+	assert(!mCells.empty());
+	assert(node.mGridEntry < 0);
+
+	// Nodes that interact with nothing never need a bounds test
+	unsigned int category = node.getCategory();
+	unsigned int partners = mMatrix.getPartners(category);
+	if (partners == 0u)
+		return;
+
+	Entry entry;
+	entry.node = &node;
+	entry.category = category;
+	entry.partners = partners;
+	computeCellRange(entry);
+
+	std::size_t index = mEntries.size();
+	mEntries.push_back(entry);
+	node.mGridEntry = static_cast<int>(index);
+
+	addToCells(index);
+}
+
+void CollisionGrid::remove(SceneNode& node)
+{
+	if (node.mGridEntry < 0)
+		return;
+
+	std::size_t index = static_cast<std::size_t>(node.mGridEntry);
+	std::size_t last = mEntries.size() - 1;
+
+	removeFromCells(index);
+
+	// Move the last entry into the gap, the cells referring to it are renamed
+	if (index != last)
+	{
+		renameInCells(last, index);
+		mEntries[index] = mEntries[last];
+		mEntries[index].node->mGridEntry = static_cast<int>(index);
+	}
+
+	mEntries.pop_back();
+	node.mGridEntry = -1;
+}
+
+void CollisionGrid::update()
+{
+	// Most nodes stay inside their cells between two frames; only the others touch the buckets
+	for (std::size_t i = 0; i < mEntries.size(); ++i)
+	{
+		Entry moved = mEntries[i];
+		computeCellRange(moved);
+
+		const Entry& entry = mEntries[i];
+		if (moved.minX == entry.minX && moved.minY == entry.minY && moved.maxX == entry.maxX && moved.maxY == entry.maxY)
+			continue;
+
+		removeFromCells(i);
+		mEntries[i] = moved;
+		addToCells(i);
+	}
+}
+
+void CollisionGrid::findPairs(std::vector<SceneNode::Pair>& collisionPairs) const
+{
+	collisionPairs.clear();
+	findPairsInRows(0, mRows, collisionPairs);
+
+	std::sort(collisionPairs.begin(), collisionPairs.end(), &pairPrecedes);
+}
+
+void CollisionGrid::findPairs(std::vector<SceneNode::Pair>& collisionPairs, JobSystem& jobs)
+{
+	// Bounding rects are cached on first use; compute them up front, so the jobs only read them
+	FOREACH(const Entry& entry, mEntries)
+		entry.node->getBoundingRect();
+
+	// Rows of cells are independent, a few jobs per thread
+	std::size_t rows = static_cast<std::size_t>(mRows);
+	std::size_t grainSize = std::max<std::size_t>(1, rows / (4 * jobs.getThreadCount()));
+	std::size_t jobCount = (rows + grainSize - 1) / grainSize;
+	if (mJobPairs.size() < jobCount)
+		mJobPairs.resize(jobCount);
+
+	jobs.parallelFor(rows, grainSize, [&] (std::size_t begin, std::size_t end)
+	{
+		std::vector<SceneNode::Pair>& pairs = mJobPairs[begin / grainSize];
+		pairs.clear();
+		findPairsInRows(static_cast<int>(begin), static_cast<int>(end), pairs);
+	});
+
+	collisionPairs.clear();
+	for (std::size_t i = 0; i < jobCount; ++i)
+		collisionPairs.insert(collisionPairs.end(), mJobPairs[i].begin(), mJobPairs[i].end());
+
+	// The split depends on the thread count, the order of the result must not
+	std::sort(collisionPairs.begin(), collisionPairs.end(), &pairPrecedes);
+}
+
+void CollisionGrid::query(sf::FloatRect rect, unsigned int categories, std::vector<SceneNode*>& result) const
+{
+	result.clear();
+
+	int minX = cellIndexX(rect.left);
+	int minY = cellIndexY(rect.top);
+	int maxX = cellIndexX(rect.left + rect.width);
+	int maxY = cellIndexY(rect.top + rect.height);
+
+	for (int y = minY; y <= maxY; ++y)
+	{
+		for (int x = minX; x <= maxX; ++x)
+		{
+			FOREACH(std::size_t index, mCells[y * mColumns + x])
+			{
+				const Entry& entry = mEntries[index];
+				if (!(entry.category & categories))
+					continue;
+
+				// Report each node only from the first cell it shares with the query rect
+				if (std::max(entry.minX, minX) != x || std::max(entry.minY, minY) != y)
+					continue;
+
+				if (entry.node->getBoundingRect().intersects(rect))
+					result.push_back(entry.node);
+			}
+		}
+	}
+}
+
+void CollisionGrid::findNearest(sf::Vector2f position, unsigned int categories, std::size_t count, std::vector<SceneNode*>& result) const
+{
+	result.clear();
+	if (count == 0)
+		return;
+
+	// Result is kept sorted by distance, nearest first
+	auto distanceTo = [position] (const SceneNode* node)
+	{
+		return length(node->getWorldPosition() - position);
+	};
+
+	int centerX = cellIndexX(position.x);
+	int centerY = cellIndexY(position.y);
+
+	// Search square rings of cells around the position, until no unvisited cell can hold anything nearer
+	for (int ring = 0; ; ++ring)
+	{
+		int minX = centerX - ring;
+		int minY = centerY - ring;
+		int maxX = centerX + ring;
+		int maxY = centerY + ring;
+
+		for (int y = std::max(minY, 0); y <= std::min(maxY, mRows - 1); ++y)
+		{
+			for (int x = std::max(minX, 0); x <= std::min(maxX, mColumns - 1); ++x)
+			{
+				// Inner cells were visited by the previous rings
+				if (x != minX && x != maxX && y != minY && y != maxY)
+					continue;
+
+				FOREACH(std::size_t index, mCells[y * mColumns + x])
+				{
+					const Entry& entry = mEntries[index];
+					if (!isCandidate(entry, categories))
+						continue;
+
+					float nodeDistance = distanceTo(entry.node);
+					if (result.size() == count && nodeDistance >= distanceTo(result.back()))
+						continue;
+
+					// Nodes spanning several cells are met more than once
+					if (std::find(result.begin(), result.end(), entry.node) != result.end())
+						continue;
+
+					auto insertPosition = result.begin();
+					while (insertPosition != result.end() && distanceTo(*insertPosition) <= nodeDistance)
+						++insertPosition;
+
+					result.insert(insertPosition, entry.node);
+					if (result.size() > count)
+						result.pop_back();
+				}
+			}
+		}
+
+		// Nodes are bucketed by their bounding rect, which contains their position. So every node not found
+		// yet is at least as far away as the nearest border of the visited square, on the sides that have cells left.
+		float unvisitedDistance = Infinity;
+		if (minX > 0)
+			unvisitedDistance = std::min(unvisitedDistance, position.x - (mBounds.left + minX * mCellSize));
+		if (minY > 0)
+			unvisitedDistance = std::min(unvisitedDistance, position.y - (mBounds.top + minY * mCellSize));
+		if (maxX < mColumns - 1)
+			unvisitedDistance = std::min(unvisitedDistance, mBounds.left + (maxX + 1) * mCellSize - position.x);
+		if (maxY < mRows - 1)
+			unvisitedDistance = std::min(unvisitedDistance, mBounds.top + (maxY + 1) * mCellSize - position.y);
+
+		if (unvisitedDistance == Infinity)
+			break;
+
+		if (result.size() == count && distanceTo(result.back()) <= unvisitedDistance)
+			break;
+	}
+}
+
+void CollisionGrid::findWithinRadius(sf::Vector2f position, float radius, unsigned int categories, std::vector<SceneNode*>& result) const
+{
+	result.clear();
+
+	int minX = cellIndexX(position.x - radius);
+	int minY = cellIndexY(position.y - radius);
+	int maxX = cellIndexX(position.x + radius);
+	int maxY = cellIndexY(position.y + radius);
+
+	for (int y = minY; y <= maxY; ++y)
+	{
+		for (int x = minX; x <= maxX; ++x)
+		{
+			FOREACH(std::size_t index, mCells[y * mColumns + x])
+			{
+				const Entry& entry = mEntries[index];
+				if (!isCandidate(entry, categories))
+					continue;
+
+				// Report each node only from the first cell it shares with the searched area
+				if (std::max(entry.minX, minX) != x || std::max(entry.minY, minY) != y)
+					continue;
+
+				if (length(entry.node->getWorldPosition() - position) <= radius)
+					result.push_back(entry.node);
+			}
+		}
+	}
+}
+
+SceneNode* CollisionGrid::findFirstAlongRay(sf::Vector2f origin, sf::Vector2f direction, float maxDistance, unsigned int categories) const
+{
+	direction = unitVector(direction);
+
+	// Walk the cells the ray passes through in order (Amanatides & Woo)
+	int x = cellIndexX(origin.x);
+	int y = cellIndexY(origin.y);
+	int stepX = (direction.x > 0.f) ? 1 : (direction.x < 0.f) ? -1 : 0;
+	int stepY = (direction.y > 0.f) ? 1 : (direction.y < 0.f) ? -1 : 0;
+
+	// Ray distance to the next vertical and horizontal cell border, and between two borders
+	float nextX = Infinity;
+	float nextY = Infinity;
+	float deltaX = Infinity;
+	float deltaY = Infinity;
+
+	if (stepX != 0)
+	{
+		nextX = (mBounds.left + (x + (stepX > 0 ? 1 : 0)) * mCellSize - origin.x) / direction.x;
+		deltaX = mCellSize / std::abs(direction.x);
+	}
+
+	if (stepY != 0)
+	{
+		nextY = (mBounds.top + (y + (stepY > 0 ? 1 : 0)) * mCellSize - origin.y) / direction.y;
+		deltaY = mCellSize / std::abs(direction.y);
+	}
+
+	// Border cells reach out to infinity (nodes outside are clamped into them), so a ray starting
+	// outside the grid and pointing away from it never crosses another border on that axis
+	if (nextX < 0.f)
+		nextX = Infinity;
+	if (nextY < 0.f)
+		nextY = Infinity;
+
+	SceneNode* closest = nullptr;
+	float closestDistance = maxDistance;
+
+	for (;;)
+	{
+		FOREACH(std::size_t index, mCells[y * mColumns + x])
+		{
+			const Entry& entry = mEntries[index];
+			if (!isCandidate(entry, categories))
+				continue;
+
+			float hitDistance;
+			if (intersectsRay(entry.node->getBoundingRect(), origin, direction, hitDistance) && hitDistance <= closestDistance)
+			{
+				closest = entry.node;
+				closestDistance = hitDistance;
+			}
+		}
+
+		// A hit before the ray leaves this cell can't be beaten by any later cell
+		float cellExit = std::min(nextX, nextY);
+		if (cellExit > closestDistance || cellExit == Infinity)
+			break;
+
+		// Leaving the grid on one axis keeps the ray inside the border cells of that axis
+		if (nextX < nextY)
+		{
+			x += stepX;
+			nextX += deltaX;
+
+			if (x < 0 || x >= mColumns)
+			{
+				x -= stepX;
+				nextX = Infinity;
+			}
+		}
+		else
+		{
+			y += stepY;
+			nextY += deltaY;
+
+			if (y < 0 || y >= mRows)
+			{
+				y -= stepY;
+				nextY = Infinity;
+			}
+		}
+	}
+
+	return closest;
+}
+
+int CollisionGrid::cellIndexX(float x) const
+{
+	int index = static_cast<int>(std::floor((x - mBounds.left) / mCellSize));
+	return std::max(0, std::min(index, mColumns - 1));
+}
+
+int CollisionGrid::cellIndexY(float y) const
+{
+	int index = static_cast<int>(std::floor((y - mBounds.top) / mCellSize));
+	return std::max(0, std::min(index, mRows - 1));
+}
+
+void CollisionGrid::computeCellRange(Entry& entry) const
+{
+	sf::FloatRect rect = entry.node->getBoundingRect();
+
+	// Nodes outside the grid are clamped to the border cells, so nothing is silently dropped
+	entry.minX = cellIndexX(rect.left);
+	entry.minY = cellIndexY(rect.top);
+	entry.maxX = cellIndexX(rect.left + rect.width);
+	entry.maxY = cellIndexY(rect.top + rect.height);
+}
+
+void CollisionGrid::addToCells(std::size_t index)
+{
+	const Entry& entry = mEntries[index];
+
+	for (int y = entry.minY; y <= entry.maxY; ++y)
+		for (int x = entry.minX; x <= entry.maxX; ++x)
+			mCells[y * mColumns + x].push_back(index);
+}
+
+void CollisionGrid::removeFromCells(std::size_t index)
+{
+	const Entry& entry = mEntries[index];
+
+	for (int y = entry.minY; y <= entry.maxY; ++y)
+	{
+		for (int x = entry.minX; x <= entry.maxX; ++x)
+		{
+			std::vector<std::size_t>& cell = mCells[y * mColumns + x];
+
+			auto found = std::find(cell.begin(), cell.end(), index);
+			assert(found != cell.end());
+
+			*found = cell.back();
+			cell.pop_back();
+		}
+	}
+}
+
+void CollisionGrid::renameInCells(std::size_t oldIndex, std::size_t newIndex)
+{
+	const Entry& entry = mEntries[oldIndex];
+
+	for (int y = entry.minY; y <= entry.maxY; ++y)
+	{
+		for (int x = entry.minX; x <= entry.maxX; ++x)
+		{
+			std::vector<std::size_t>& cell = mCells[y * mColumns + x];
+			std::replace(cell.begin(), cell.end(), oldIndex, newIndex);
+		}
+	}
+}
+
+void CollisionGrid::findPairsInRows(int beginRow, int endRow, std::vector<SceneNode::Pair>& collisionPairs) const
+{
+	for (int y = beginRow; y < endRow; ++y)
+	{
+		for (int x = 0; x < mColumns; ++x)
+		{
+			const std::vector<std::size_t>& cell = mCells[y * mColumns + x];
+
+			for (std::size_t i = 0; i < cell.size(); ++i)
+			{
+				const Entry& lhs = mEntries[cell[i]];
+
+				for (std::size_t j = i + 1; j < cell.size(); ++j)
+				{
+					const Entry& rhs = mEntries[cell[j]];
+
+					// Skip category pairs without a registered handler
+					if (!(lhs.partners & rhs.category))
+						continue;
+
+					// Nodes spanning several cells meet more than once; only the first shared cell reports the pair
+					if (std::max(lhs.minX, rhs.minX) != x || std::max(lhs.minY, rhs.minY) != y)
+						continue;
+
+					// Destroyed nodes stay in the grid until they are removed from the scene
+					if (lhs.node->isDestroyed() || rhs.node->isDestroyed())
+						continue;
+
+					if (collision(*lhs.node, *rhs.node))
+						collisionPairs.push_back(makePair(lhs.node, rhs.node));
+				}
+			}
+		}
+	}
+}
+
+bool CollisionGrid::isCandidate(const Entry& entry, unsigned int categories) const
+{
+	return (entry.category & categories) && !entry.node->isDestroyed();
+}
@@ -0,0 +1,79 @@
+#ifndef H_COLLISIONGRID
+#define H_COLLISIONGRID
+
+#include "SceneNode.h"
+#include "CollisionMatrix.h"
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+#include <vector>
+
+
+class JobSystem;
+
+// Uniform grid over the world: collidable nodes are bucketed into fixed-size cells.
+// The grid is kept up to date incrementally; nodes are inserted when attached, removed
+// when detached and only moved between cells by update() when their cell range changes.
+// Serves as broad phase (findPairs) and as spatial index for gameplay queries. Nodes whose category
+// has no partner in the collision matrix are left out, so queries don't find them either.
+// Pairs are reported in a canonical order, ordered by the creation sequence of their nodes.
+class CollisionGrid : private sf::NonCopyable
+{
+	public:
+									CollisionGrid(float cellSize, const CollisionMatrix& matrix);
+
+		void						reset(sf::FloatRect bounds);
+		void						insert(SceneNode& node);
+		void						remove(SceneNode& node);
+		void						update();
+
+		void						findPairs(std::vector<SceneNode::Pair>& collisionPairs) const;
+
+		// Same result, with the narrow phase spread over the job system; every job collects into a buffer of its own
+		void						findPairs(std::vector<SceneNode::Pair>& collisionPairs, JobSystem& jobs);
+		void						query(sf::FloatRect rect, unsigned int categories, std::vector<SceneNode*>& result) const;
+
+		// Gameplay queries; skip destroyed nodes and measure distances to world positions
+		void						findNearest(sf::Vector2f position, unsigned int categories, std::size_t count, std::vector<SceneNode*>& result) const;
+		void						findWithinRadius(sf::Vector2f position, float radius, unsigned int categories, std::vector<SceneNode*>& result) const;
+		SceneNode*					findFirstAlongRay(sf::Vector2f origin, sf::Vector2f direction, float maxDistance, unsigned int categories) const;
+
+
+	private:
+		struct Entry
+		{
+			SceneNode*				node;
+			unsigned int			category;
+			unsigned int			partners;
+			int						minX;
+			int						minY;
+			int						maxX;
+			int						maxY;
+		};
+
+
+	private:
+		int							cellIndexX(float x) const;
+		int							cellIndexY(float y) const;
+		void						computeCellRange(Entry& entry) const;
+		void						addToCells(std::size_t index);
+		void						removeFromCells(std::size_t index);
+		void						renameInCells(std::size_t oldIndex, std::size_t newIndex);
+		void						findPairsInRows(int beginRow, int endRow, std::vector<SceneNode::Pair>& collisionPairs) const;
+		bool						isCandidate(const Entry& entry, unsigned int categories) const;
+
+
+	private:
+		float						mCellSize;
+		const CollisionMatrix&		mMatrix;
+		sf::FloatRect				mBounds;
+		int							mColumns;
+		int							mRows;
+
+		std::vector<Entry>						mEntries;
+		std::vector<std::vector<std::size_t>>	mCells;
+		std::vector<std::vector<SceneNode::Pair>>	mJobPairs;
+};
+
+#endif
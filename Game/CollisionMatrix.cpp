@@ -0,0 +1,83 @@
+#include "CollisionMatrix.h"
+
+
+CollisionMatrix::CollisionMatrix()
+: mHandlers()
+, mSlots(BitCount * BitCount)
+, mPartners(BitCount, 0u)
+{
+	for (std::size_t i = 0; i < mSlots.size(); ++i)
+	{
+		mSlots[i].handler = -1;
+		mSlots[i].swapped = false;
+	}
+}
+
+void CollisionMatrix::addHandler(unsigned int first, unsigned int second, Handler handler)
+{
+	int index = static_cast<int>(mHandlers.size());
+	mHandlers.push_back(handler);
+
+	// Categories may be masks (e.g. Category::Projectile): register every bit combination
+	for (std::size_t i = 0; i < BitCount; ++i)
+	{
+		if (!(first & (1u << i)))
+			continue;
+
+		for (std::size_t j = 0; j < BitCount; ++j)
+		{
+			if (!(second & (1u << j)))
+				continue;
+
+			assert(mSlots[i * BitCount + j].handler == -1);
+
+			mSlots[i * BitCount + j].handler = index;
+			mSlots[i * BitCount + j].swapped = false;
+			mSlots[j * BitCount + i].handler = index;
+			mSlots[j * BitCount + i].swapped = true;
+
+			mPartners[i] |= 1u << j;
+			mPartners[j] |= 1u << i;
+		}
+	}
+}
+
+unsigned int CollisionMatrix::getPartners(unsigned int category) const
+{
+	unsigned int partners = 0u;
+	for (std::size_t i = 0; i < BitCount; ++i)
+	{
+		if (category & (1u << i))
+			partners |= mPartners[i];
+	}
+
+	return partners;
+}
+
+void CollisionMatrix::dispatch(SceneNode& lhs, SceneNode& rhs) const
+{
+	const Slot& slot = mSlots[bitIndex(lhs.getCategory()) * BitCount + bitIndex(rhs.getCategory())];
+	if (slot.handler < 0)
+		return;
+
+	// Handlers always receive their nodes in registration order
+	if (slot.swapped)
+		mHandlers[slot.handler](rhs, lhs);
+	else
+		mHandlers[slot.handler](lhs, rhs);
+}
+
+std::size_t CollisionMatrix::bitIndex(unsigned int category)
+{
+	// Colliding entities carry exactly one category bit
+	assert(category != 0 && (category & (category - 1)) == 0);
+
+	std::size_t index = 0;
+	while (!(category & 1u))
+	{
+		category >>= 1;
+		++index;
+	}
+
+	return index;
+}
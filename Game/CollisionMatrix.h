@@ -0,0 +1,64 @@
+#ifndef H_COLLISIONMATRIX
+#define H_COLLISIONMATRIX
+
+#include "Category.h"
+#include "SceneNode.h"
+
+#include <functional>
+#include <vector>
+#include <cassert>
+
+
+// Declares which category pairs interact and which handler resolves them.
+// Pairs that are not registered are pruned before any bounds test.
+class CollisionMatrix
+{
+	public:
+		typedef std::function<void(SceneNode&, SceneNode&)> Handler;
+
+
+	public:
+									CollisionMatrix();
+
+		void						addHandler(unsigned int first, unsigned int second, Handler handler);
+
+		unsigned int				getPartners(unsigned int category) const;
+		void						dispatch(SceneNode& lhs, SceneNode& rhs) const;
+
+
+	private:
+		struct Slot
+		{
+			int						handler;
+			bool					swapped;
+		};
+
+		static const std::size_t	BitCount = 32;
+
+
+	private:
+		static std::size_t			bitIndex(unsigned int category);
+
+
+	private:
+		std::vector<Handler>		mHandlers;
+		std::vector<Slot>			mSlots;
+		std::vector<unsigned int>	mPartners;
+};
+
+
+template <typename First, typename Second, typename Function>
+CollisionMatrix::Handler derivedCollision(Function fn)
+{
+	return [=] (SceneNode& first, SceneNode& second)
+	{
+		// Check if casts are safe
+		assert(dynamic_cast<First*>(&first) != nullptr);
+		assert(dynamic_cast<Second*>(&second) != nullptr);
+
+		// Downcast nodes and invoke function on them
+		fn(static_cast<First&>(first), static_cast<Second&>(second));
+	};
+}
+
+#endif
@@ -2,10 +2,10 @@
 #define H_COMMAND
 
 #include "Category.h"
+#include "CommandAction.h"
 
 #include <SFML/System/Time.hpp>
 
-#include <functional>
 #include <cassert>
 
 
@@ -13,10 +13,10 @@ class SceneNode;
 
 struct Command
 {
-		typedef std::function<void(SceneNode&, sf::Time)> Action;
+		typedef CommandAction					Action;
 												Command();
 
-	std::function<void(SceneNode&, sf::Time)>	action;
+	Action										action;
 	unsigned int								category;
 };
 
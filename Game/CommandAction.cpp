@@ -0,0 +1,74 @@
+#include "CommandAction.h"
+
+
+CommandAction::CommandAction()
+: mOperations(nullptr)
+{
+}
+
+CommandAction::CommandAction(const CommandAction& other)
+: mOperations(other.mOperations)
+{
+	if (mOperations)
+		mOperations->copy(&mStorage, &other.mStorage);
+}
+
+CommandAction::CommandAction(CommandAction&& other)
+: mOperations(other.mOperations)
+{
+	if (mOperations)
+		mOperations->move(&mStorage, &other.mStorage);
+}
+
+CommandAction::~CommandAction()
+{
+	reset();
+}
+
+CommandAction& CommandAction::operator= (const CommandAction& other)
+{
+	if (this != &other)
+	{
+		reset();
+
+		mOperations = other.mOperations;
+		if (mOperations)
+			mOperations->copy(&mStorage, &other.mStorage);
+	}
+
+	return *this;
+}
+
+CommandAction& CommandAction::operator= (CommandAction&& other)
+{
+	if (this != &other)
+	{
+		reset();
+
+		mOperations = other.mOperations;
+		if (mOperations)
+			mOperations->move(&mStorage, &other.mStorage);
+	}
+
+	return *this;
+}
+
+void CommandAction::operator() (SceneNode& node, sf::Time dt) const
+{
+	assert(mOperations);
+	mOperations->invoke(&mStorage, node, dt);
+}
+
+bool CommandAction::isEmpty() const
+{
+	return mOperations == nullptr;
+}
+
+void CommandAction::reset()
+{
+	if (mOperations)
+	{
+		mOperations->destroy(&mStorage);
+		mOperations = nullptr;
+	}
+}
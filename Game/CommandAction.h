@@ -0,0 +1,115 @@
+#ifndef H_COMMANDACTION
+#define H_COMMANDACTION
+
+#include <SFML/System/Time.hpp>
+
+#include <type_traits>
+#include <utility>
+#include <new>
+#include <cassert>
+
+
+class SceneNode;
+
+// Callable with signature void(SceneNode&, sf::Time), like std::function, but
+// the functor is always stored inline. Copying or moving an action never allocates;
+// functors that don't fit into the buffer are rejected at compile time.
+class CommandAction
+{
+	public:
+		static const std::size_t	Capacity = 48;
+
+
+	public:
+									CommandAction();
+									CommandAction(const CommandAction& other);
+									CommandAction(CommandAction&& other);
+									~CommandAction();
+
+		template <typename Function>
+									CommandAction(Function fn);
+
+		CommandAction&				operator= (const CommandAction& other);
+		CommandAction&				operator= (CommandAction&& other);
+
+		void						operator() (SceneNode& node, sf::Time dt) const;
+		bool						isEmpty() const;
+
+
+	private:
+		struct Operations
+		{
+			void					(*invoke)(const void* functor, SceneNode& node, sf::Time dt);
+			void					(*copy)(void* destination, const void* source);
+			void					(*move)(void* destination, void* source);
+			void					(*destroy)(void* functor);
+		};
+
+		template <typename Function>
+		struct Model
+		{
+			static void				invoke(const void* functor, SceneNode& node, sf::Time dt);
+			static void				copy(void* destination, const void* source);
+			static void				move(void* destination, void* source);
+			static void				destroy(void* functor);
+
+			static const Operations	operations;
+		};
+
+		typedef std::aligned_storage<Capacity>::type Storage;
+
+
+	private:
+		void						reset();
+
+
+	private:
+		Storage						mStorage;
+		const Operations*			mOperations;
+};
+
+
+template <typename Function>
+CommandAction::CommandAction(Function fn)
+: mOperations(&Model<Function>::operations)
+{
+	static_assert(sizeof(Function) <= Capacity, "CommandAction: functor too large for inline storage");
+	static_assert(std::alignment_of<Function>::value <= std::alignment_of<Storage>::value, "CommandAction: functor alignment not supported");
+
+	new (&mStorage) Function(std::move(fn));
+}
+
+template <typename Function>
+void CommandAction::Model<Function>::invoke(const void* functor, SceneNode& node, sf::Time dt)
+{
+	(*static_cast<const Function*>(functor))(node, dt);
+}
+
+template <typename Function>
+void CommandAction::Model<Function>::copy(void* destination, const void* source)
+{
+	new (destination) Function(*static_cast<const Function*>(source));
+}
+
+template <typename Function>
+void CommandAction::Model<Function>::move(void* destination, void* source)
+{
+	new (destination) Function(std::move(*static_cast<Function*>(source)));
+}
+
+template <typename Function>
+void CommandAction::Model<Function>::destroy(void* functor)
+{
+	static_cast<Function*>(functor)->~Function();
+}
+
+template <typename Function>
+const CommandAction::Operations CommandAction::Model<Function>::operations =
+{
+	&CommandAction::Model<Function>::invoke,
+	&CommandAction::Model<Function>::copy,
+	&CommandAction::Model<Function>::move,
+	&CommandAction::Model<Function>::destroy,
+};
+
+#endif
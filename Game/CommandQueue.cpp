@@ -1,20 +1,68 @@
 #include "CommandQueue.h"
 #include "SceneNode.h"
 
+#include <cassert>
+
+
+namespace
+{
+	// Must be a power of two, so indices can wrap with a mask
+	const std::size_t InitialCapacity = 64;
+}
+
+CommandQueue::CommandQueue()
+: mBuffer(InitialCapacity)
+, mHead(0)
+, mSize(0)
+{
+}
 
 void CommandQueue::push(const Command& command)
 {
-	mQueue.push(command);
+	if (mSize == mBuffer.size())
+		grow();
+
+	mBuffer[(mHead + mSize) & (mBuffer.size() - 1)] = command;
+	++mSize;
+}
+
+void CommandQueue::push(Command&& command)
+{
+	if (mSize == mBuffer.size())
+		grow();
+
+	mBuffer[(mHead + mSize) & (mBuffer.size() - 1)] = std::move(command);
+	++mSize;
 }
 
 Command CommandQueue::pop()
 {
-	Command command = mQueue.front();
-	mQueue.pop();
+	assert(!isEmpty());
+
+	Command command = std::move(mBuffer[mHead]);
+	mHead = (mHead + 1) & (mBuffer.size() - 1);
+	--mSize;
+
 	return command;
 }
 
 bool CommandQueue::isEmpty() const
 {
-	return mQueue.empty();
+	return mSize == 0;
+}
+
+std::size_t CommandQueue::getSize() const
+{
+	return mSize;
+}
+
+void CommandQueue::grow()
+{
+	// Unroll the pending commands to the front of a buffer twice the size
+	std::vector<Command> buffer(mBuffer.size() * 2);
+	for (std::size_t i = 0; i < mSize; ++i)
+		buffer[i] = std::move(mBuffer[(mHead + i) & (mBuffer.size() - 1)]);
+
+	mBuffer.swap(buffer);
+	mHead = 0;
 }
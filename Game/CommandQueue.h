@@ -3,19 +3,31 @@
 
 #include "Command.h"
 
-#include <queue>
+#include <vector>
 
 
+// FIFO of commands in a ring buffer. Slots are reused, the buffer only grows
+// when more commands are pending than ever before.
 class CommandQueue
 {
 	public:
+									CommandQueue();
+
 		void						push(const Command& command);
+		void						push(Command&& command);
 		Command						pop();
 		bool						isEmpty() const;
+		std::size_t					getSize() const;
 
 		
 	private:
-		std::queue<Command>			mQueue;
+		void						grow();
+
+
+	private:
+		std::vector<Command>		mBuffer;
+		std::size_t					mHead;
+		std::size_t					mSize;
 };
 
-#endif 
\ No newline at end of file
+#endif
@@ -1,6 +1,6 @@
 #include "DataTables.h"
 #include "Animal.h"
-#include "Projectile.h"
+#include "ProjectileSystem.h"
 #include "Pickup.h"
 
 
@@ -28,19 +28,22 @@ std::vector<AnimalData> initializeAnimalData()
 
 std::vector<ProjectileData> initializeProjectileData()
 {
-	std::vector<ProjectileData> data(Projectile::TypeCount);
+	std::vector<ProjectileData> data(ProjectileSystem::TypeCount);
 
-	data[Projectile::AlliedLaser].damage = 10;
-	data[Projectile::AlliedLaser].speed = 300.f;
-	data[Projectile::AlliedLaser].texture = Textures::LaserBeam;
+	data[ProjectileSystem::AlliedLaser].damage = 10;
+	data[ProjectileSystem::AlliedLaser].speed = 300.f;
+	data[ProjectileSystem::AlliedLaser].texture = Textures::LaserBeam;
+	data[ProjectileSystem::AlliedLaser].targets = Category::EnemyAnimal;
 
-	data[Projectile::EnemyLaser].damage = 10;
-	data[Projectile::EnemyLaser].speed = 300.f;
-	data[Projectile::EnemyLaser].texture = Textures::LaserBeam;
+	data[ProjectileSystem::EnemyLaser].damage = 10;
+	data[ProjectileSystem::EnemyLaser].speed = 300.f;
+	data[ProjectileSystem::EnemyLaser].texture = Textures::LaserBeam;
+	data[ProjectileSystem::EnemyLaser].targets = Category::PlayerAnimal;
 
-	data[Projectile::Quack].damage = 200;
-	data[Projectile::Quack].speed = 150.f;
-	data[Projectile::Quack].texture = Textures::Quack;
+	data[ProjectileSystem::Quack].damage = 200;
+	data[ProjectileSystem::Quack].speed = 150.f;
+	data[ProjectileSystem::Quack].texture = Textures::Quack;
+	data[ProjectileSystem::Quack].targets = Category::EnemyAnimal;
 
 	return data;
 }
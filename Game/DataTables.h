@@ -1,7 +1,7 @@
 #ifndef H_DATATABLES
 #define H_DATATABLES
 
-#include "ResourceIdentifiers.h"
+#include "resourceIdentifiers.h"
 
 #include <SFML/System/Time.hpp>
 #include <SFML/Graphics/Color.hpp>
@@ -38,6 +38,7 @@ struct ProjectileData
 	int								damage;
 	float							speed;
 	Textures::ID					texture;
+	unsigned int					targets;
 };
 
 struct PickupData
@@ -2,9 +2,12 @@
 #include <cassert>
 
 
-Entity::Entity(int hitpoints)
-: mVelocity()
+Entity::Entity(HandleTable& handles, int hitpoints)
+: SceneNode(handles)
+, mVelocity()
 , mHitpoints(hitpoints)
+, mPreviousPosition()
+, mHasPreviousPosition(false)
 {
 }
 
@@ -26,8 +29,20 @@ sf::Vector2f Entity::getVelocity() const
 
 void Entity::updateCurrent(sf::Time dt, CommandQueue&)
 {	
+	mPreviousPosition = getPosition();
+	mHasPreviousPosition = true;
+
 	move(mVelocity * dt.asSeconds());
 }
+
+sf::Vector2f Entity::getRenderOffset(float alpha) const
+{
+	// Entities that haven't been updated yet are drawn where they were placed
+	if (!mHasPreviousPosition)
+		return sf::Vector2f();
+
+	return (mPreviousPosition - getPosition()) * (1.f - alpha);
+}
 void Entity::accelerate(sf::Vector2f velocity)
 {
 	mVelocity += velocity;
@@ -7,7 +7,7 @@
 class Entity : public SceneNode
 {
 	public:
-							Entity(int hitpoints);
+							Entity(HandleTable& handles, int hitpoints);
 		void				setVelocity(sf::Vector2f velocity);
 		void				setVelocity(float vx, float vy);
 		void				accelerate(sf::Vector2f velocity);
@@ -22,11 +22,14 @@ class Entity : public SceneNode
 
 protected:
 		virtual void		updateCurrent(sf::Time dt, CommandQueue& commands);
+		virtual sf::Vector2f	getRenderOffset(float alpha) const;
 
 
 	private:
 		sf::Vector2f		mVelocity;
 		int					mHitpoints;
+		sf::Vector2f		mPreviousPosition;
+		bool				mHasPreviousPosition;
 };
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "FrameSnapshot.h"
+#include "Foreach.h"
+#include "Utility.h"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Font.hpp>
+
+#include <cassert>
+
+
+FrameSnapshot::FrameSnapshot()
+: mViews()
+, mItems()
+, mCopies()
+, mBatches()
+, mBatchCount(0)
+{
+}
+
+void FrameSnapshot::clear()
+{
+	mViews.clear();
+	mItems.clear();
+	mCopies.clear();
+	mBatchCount = 0;
+}
+
+void FrameSnapshot::setView(const sf::View& view)
+{
+	mViews.push_back(view);
+}
+
+SpriteBatch& FrameSnapshot::addBatch()
+{
+	if (mBatchCount == mBatches.size())
+		mBatches.push_back(std::unique_ptr<SpriteBatch>(new SpriteBatch()));
+
+	SpriteBatch& batch = *mBatches[mBatchCount++];
+	batch.clear();
+
+	addItem(batch);
+	return batch;
+}
+
+void FrameSnapshot::add(const sf::Text& text)
+{
+	// Only the glyph quads are recorded, so the drawing thread never touches the font itself
+	const sf::Font* font = text.getFont();
+	if (!font)
+		return;
+
+	assert(text.getStyle() == sf::Text::Regular);
+
+	unsigned int characterSize = text.getCharacterSize();
+	sf::VertexArray& vertices = addBatch().getVertices(font->getTexture(characterSize));
+	appendTextGeometry(vertices, *font, text.getString(), characterSize, text.getColor(), text.getTransform());
+}
+
+void FrameSnapshot::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	std::size_t currentView = DefaultView;
+	target.setView(target.getDefaultView());
+
+	FOREACH(const Item& item, mItems)
+	{
+		if (item.view != currentView)
+		{
+			currentView = item.view;
+			target.setView(mViews[currentView]);
+		}
+
+		target.draw(*item.drawable, states);
+	}
+}
+
+void FrameSnapshot::addItem(const sf::Drawable& drawable)
+{
+	Item item = { mViews.empty() ? DefaultView : mViews.size() - 1, &drawable };
+	mItems.push_back(item);
+}
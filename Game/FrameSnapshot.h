@@ -0,0 +1,69 @@
+#ifndef H_FRAMESNAPSHOT
+#define H_FRAMESNAPSHOT
+
+#include "SpriteBatch.h"
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/View.hpp>
+#include <SFML/Graphics/Text.hpp>
+
+#include <vector>
+#include <memory>
+
+
+// Everything to draw in one frame, recorded by value: views, sprite batches and copies of
+// other drawables. Once recorded, a snapshot doesn't refer to the scene or the states any
+// more, so it can be drawn on another thread while the next frame is simulated.
+// Textures are still referenced, their owners have to outlive the frames that use them.
+// Batches are kept between frames, so their vertex arrays don't reallocate.
+class FrameSnapshot : public sf::Drawable, private sf::NonCopyable
+{
+	public:
+									FrameSnapshot();
+
+		void						clear();
+		void						setView(const sf::View& view);
+
+		// Batch filled in place, drawn at this position in the frame
+		SpriteBatch&				addBatch();
+
+		template <typename T>
+		void						add(const T& drawable);
+		// Recorded as glyph quads; the glyphs must already be in the font's texture if another thread draws
+		void						add(const sf::Text& text);
+
+
+	private:
+		struct Item
+		{
+			std::size_t				view;
+			const sf::Drawable*		drawable;
+		};
+
+		static const std::size_t	DefaultView = static_cast<std::size_t>(-1);
+
+
+	private:
+		virtual void				draw(sf::RenderTarget& target, sf::RenderStates states) const;
+		void						addItem(const sf::Drawable& drawable);
+
+
+	private:
+		std::vector<sf::View>						mViews;
+		std::vector<Item>							mItems;
+		std::vector<std::unique_ptr<sf::Drawable>>	mCopies;
+		std::vector<std::unique_ptr<SpriteBatch>>	mBatches;
+		std::size_t									mBatchCount;
+};
+
+
+template <typename T>
+void FrameSnapshot::add(const T& drawable)
+{
+	std::unique_ptr<sf::Drawable> copy(new T(drawable));
+	addItem(*copy);
+	mCopies.push_back(std::move(copy));
+}
+
+#endif
@@ -1,7 +1,8 @@
 #include "GameOverState.h"
+#include "FrameSnapshot.h"
 #include "Utility.h"
 #include "Player.h"
-#include "ResourceHolder.h"
+#include "AssetCache.h"
 
 #include <SFML/Graphics/RectangleShape.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
@@ -13,7 +14,7 @@ GameOverState::GameOverState(StateStack& stack, Context context)
 , mGameOverText()
 , mElapsedTime(sf::Time::Zero)
 {
-	sf::Font& font = context.fonts->get(Fonts::Main);
+	sf::Font& font = context.assets->getFonts().get(Fonts::Main);
 	sf::Vector2f windowSize(context.window->getSize());
 
 	mGameOverText.setFont(font);
@@ -27,18 +28,18 @@ GameOverState::GameOverState(StateStack& stack, Context context)
 	mGameOverText.setPosition(0.5f * windowSize.x, 0.4f * windowSize.y);
 }
 
-void GameOverState::draw()
+void GameOverState::draw(FrameSnapshot& frame, float)
 {
 	sf::RenderWindow& window = *getContext().window;
-	window.setView(window.getDefaultView());
+	frame.setView(window.getDefaultView());
 
 	// Create dark, semitransparent background
 	sf::RectangleShape backgroundShape;
 	backgroundShape.setFillColor(sf::Color(0, 0, 0, 150));
-	backgroundShape.setSize(window.getView().getSize());
+	backgroundShape.setSize(window.getDefaultView().getSize());
 
-	window.draw(backgroundShape);
-	window.draw(mGameOverText);
+	frame.add(backgroundShape);
+	frame.add(mGameOverText);
 }
 
 bool GameOverState::update(sf::Time dt)
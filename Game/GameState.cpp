@@ -1,21 +1,33 @@
 #include "GameState.h"
+#include "FrameSnapshot.h"
+
+#include <ctime>
 
 
 GameState::GameState(StateStack& stack, Context context)
 : State(stack, context)
-, mWorld(*context.window, *context.fonts)
+, mWorld(sf::Vector2f(context.window->getSize()), context.window, *context.assets, context.player->startMission(static_cast<sf::Uint64>(std::time(nullptr))), context.jobs)
 , mPlayer(*context.player)
 {
 	mPlayer.setMissionStatus(Player::MissionRunning);
 }
 
-void GameState::draw()
+GameState::~GameState()
+{
+	mPlayer.endMission();
+}
+
+void GameState::draw(FrameSnapshot& frame, float alpha)
 {
-	mWorld.draw();
+	mWorld.draw(frame, alpha);
 }
 
 bool GameState::update(sf::Time dt)
 {
+	// The actions since the last tick, from the keyboard or a replay
+	CommandQueue& commands = mWorld.getCommandQueue();
+	mPlayer.pushCommands(commands);
+
 	mWorld.update(dt);
 
 	if(!mWorld.hasAlivePlayer())
@@ -30,9 +42,11 @@ bool GameState::update(sf::Time dt)
 		requestStackPush(States::GameOver);//again, game over
 	}
 
+	mPlayer.handleRealtimeInput();
 
-	CommandQueue& commands = mWorld.getCommandQueue();
-	mPlayer.handleRealtimeInput(commands);
+	// A finished replay ends the session, so replays can be scripted
+	if (mPlayer.isReplayFinished())
+		requestStateClear();
 
 	return true;
 }
@@ -40,8 +54,7 @@ bool GameState::update(sf::Time dt)
 bool GameState::handleEvent(const sf::Event& event)
 {
 	// Game input handling
-	CommandQueue& commands = mWorld.getCommandQueue();
-	mPlayer.handleEvent(event, commands);
+	mPlayer.handleEvent(event);
 
 	// Escape pressed, trigger the pause screen
 	if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape)
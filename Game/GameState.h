@@ -13,8 +13,9 @@ class GameState : public State
 {
 	public:
 							GameState(StateStack& stack, Context context);
+							~GameState();
 
-		virtual void		draw();
+		virtual void		draw(FrameSnapshot& frame, float alpha);
 		virtual bool		update(sf::Time dt);
 		virtual bool		handleEvent(const sf::Event& event);
 
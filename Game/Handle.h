@@ -0,0 +1,75 @@
+#ifndef H_HANDLE
+#define H_HANDLE
+
+#include "SceneNode.h"
+
+#include <cassert>
+
+
+// Weak, checkable reference to a scene node of type Node. Cheap to copy and store;
+// get() returns nullptr once the node has been destroyed. Resolved through the handle table of the node's world.
+template <typename Node>
+class Handle
+{
+	public:
+								Handle();
+		explicit				Handle(const Node& node);
+
+		Node*					get() const;
+		Node*					operator-> () const;
+		Node&					operator* () const;
+		bool					isValid() const;
+
+
+	private:
+		const HandleTable*		mTable;
+		HandleTable::Id			mId;
+};
+
+
+template <typename Node>
+Handle<Node>::Handle()
+: mTable(nullptr)
+{
+	mId.index = 0;
+	mId.generation = 0;
+}
+
+template <typename Node>
+Handle<Node>::Handle(const Node& node)
+: mTable(&node.getHandleTable())
+, mId(node.getHandleId())
+{
+}
+
+template <typename Node>
+Node* Handle<Node>::get() const
+{
+	SceneNode* node = mTable ? mTable->get(mId) : nullptr;
+
+	// The table holds any kind of node; a live one of another type means the id got mixed up. Only checked in debug builds
+	assert(dynamic_cast<Node*>(node) == node);
+	return static_cast<Node*>(node);
+}
+
+template <typename Node>
+Node* Handle<Node>::operator-> () const
+{
+	Node* node = get();
+	assert(node != nullptr);
+	return node;
+}
+
+template <typename Node>
+Node& Handle<Node>::operator* () const
+{
+	return *operator->();
+}
+
+template <typename Node>
+bool Handle<Node>::isValid() const
+{
+	return get() != nullptr;
+}
+
+#endif
@@ -0,0 +1,81 @@
+#include "HandleTable.h"
+
+#include <cassert>
+
+
+namespace
+{
+	// Terminates the free list
+	const unsigned int NoSlot = static_cast<unsigned int>(-1);
+}
+
+HandleTable::HandleTable()
+: mSlots()
+, mFirstFree(NoSlot)
+, mSize(0)
+, mNextSequence(0)
+{
+}
+
+HandleTable::Id HandleTable::insert(SceneNode& node)
+{
+	// Reuse the most recently freed slot, append otherwise
+	if (mFirstFree == NoSlot)
+	{
+		Slot slot;
+		// Generation 0 is never handed out, so a zero-initialized id never resolves
+		slot.node = nullptr;
+		slot.sequence = 0;
+		slot.generation = 1;
+		slot.nextFree = NoSlot;
+
+		mFirstFree = static_cast<unsigned int>(mSlots.size());
+		mSlots.push_back(slot);
+	}
+
+	Slot& slot = mSlots[mFirstFree];
+	mFirstFree = slot.nextFree;
+	slot.node = &node;
+	slot.sequence = mNextSequence++;
+	++mSize;
+
+	Id id;
+	id.index = static_cast<unsigned int>(&slot - &mSlots[0]);
+	id.generation = slot.generation;
+
+	return id;
+}
+
+void HandleTable::remove(Id id)
+{
+	assert(get(id) != nullptr);
+
+	Slot& slot = mSlots[id.index];
+	slot.node = nullptr;
+	slot.nextFree = mFirstFree;
+	mFirstFree = id.index;
+	--mSize;
+
+	// Invalidate all outstanding ids of this slot
+	if (++slot.generation == 0)
+		slot.generation = 1;
+}
+
+SceneNode* HandleTable::get(Id id) const
+{
+	if (id.index >= mSlots.size() || mSlots[id.index].generation != id.generation)
+		return nullptr;
+
+	return mSlots[id.index].node;
+}
+
+sf::Uint64 HandleTable::getSequence(Id id) const
+{
+	assert(get(id) != nullptr);
+	return mSlots[id.index].sequence;
+}
+
+std::size_t HandleTable::getSize() const
+{
+	return mSize;
+}
@@ -0,0 +1,52 @@
+#ifndef H_HANDLETABLE
+#define H_HANDLETABLE
+
+#include <SFML/Config.hpp>
+#include <SFML/System/NonCopyable.hpp>
+
+#include <vector>
+
+
+class SceneNode;
+
+// Maps generational ids to scene nodes. A slot is reused once its node is removed,
+// but with a new generation, so ids of the old node resolve to nullptr instead of dangling.
+// Every insert also gets a sequence number, which counts up and is never reused.
+class HandleTable : private sf::NonCopyable
+{
+	public:
+		struct Id
+		{
+			unsigned int			index;
+			unsigned int			generation;
+		};
+
+
+	public:
+									HandleTable();
+
+		Id							insert(SceneNode& node);
+		void						remove(Id id);
+		SceneNode*					get(Id id) const;
+		sf::Uint64					getSequence(Id id) const;
+		std::size_t					getSize() const;
+
+
+	private:
+		struct Slot
+		{
+			SceneNode*				node;
+			sf::Uint64				sequence;
+			unsigned int			generation;
+			unsigned int			nextFree;
+		};
+
+
+	private:
+		std::vector<Slot>			mSlots;
+		unsigned int				mFirstFree;
+		std::size_t					mSize;
+		sf::Uint64					mNextSequence;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#include "InputRecording.h"
+
+#include <fstream>
+#include <algorithm>
+#include <cassert>
+
+
+namespace
+{
+	// File layout: magic, version, seed (8 bytes), tick count (4 bytes), one byte per tick.
+	// Integers are little endian, independent of the platform.
+	const char			Magic[4] = { 'D', 'R', 'I', 'R' };
+	const sf::Uint8		Version = 1;
+
+	void writeInteger(std::ostream& stream, sf::Uint64 value, std::size_t bytes)
+	{
+		for (std::size_t i = 0; i < bytes; ++i)
+			stream.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+	}
+
+	sf::Uint64 readInteger(std::istream& stream, std::size_t bytes)
+	{
+		sf::Uint64 value = 0;
+		for (std::size_t i = 0; i < bytes; ++i)
+			value |= static_cast<sf::Uint64>(static_cast<sf::Uint8>(stream.get())) << (8 * i);
+
+		return value;
+	}
+}
+
+InputRecording::InputRecording()
+: mSeed(0)
+, mTicks()
+{
+}
+
+void InputRecording::reset(sf::Uint64 seed)
+{
+	mSeed = seed;
+	mTicks.clear();
+}
+
+void InputRecording::addTick(unsigned int actions)
+{
+	// All player actions fit into one byte
+	assert(actions <= 0xFF);
+	mTicks.push_back(static_cast<sf::Uint8>(actions));
+}
+
+sf::Uint64 InputRecording::getSeed() const
+{
+	return mSeed;
+}
+
+std::size_t InputRecording::getTickCount() const
+{
+	return mTicks.size();
+}
+
+unsigned int InputRecording::getActions(std::size_t tick) const
+{
+	assert(tick < mTicks.size());
+	return mTicks[tick];
+}
+
+bool InputRecording::saveToFile(const std::string& filename) const
+{
+	std::ofstream file(filename.c_str(), std::ios::binary);
+	if (!file)
+		return false;
+
+	file.write(Magic, sizeof(Magic));
+	file.put(static_cast<char>(Version));
+	writeInteger(file, mSeed, 8);
+	writeInteger(file, mTicks.size(), 4);
+
+	if (!mTicks.empty())
+		file.write(reinterpret_cast<const char*>(&mTicks[0]), mTicks.size());
+
+	return static_cast<bool>(file);
+}
+
+bool InputRecording::loadFromFile(const std::string& filename)
+{
+	std::ifstream file(filename.c_str(), std::ios::binary);
+	if (!file)
+		return false;
+
+	char magic[sizeof(Magic)];
+	file.read(magic, sizeof(magic));
+	if (!file || !std::equal(magic, magic + sizeof(magic), Magic) || file.get() != Version)
+		return false;
+
+	sf::Uint64 seed = readInteger(file, 8);
+	std::size_t tickCount = static_cast<std::size_t>(readInteger(file, 4));
+
+	std::vector<sf::Uint8> ticks(tickCount);
+	if (tickCount > 0)
+		file.read(reinterpret_cast<char*>(&ticks[0]), tickCount);
+
+	if (!file)
+		return false;
+
+	mSeed = seed;
+	mTicks.swap(ticks);
+	return true;
+}
@@ -0,0 +1,34 @@
+#ifndef H_INPUTRECORDING
+#define H_INPUTRECORDING
+
+#include <SFML/Config.hpp>
+
+#include <vector>
+#include <string>
+
+
+// The player's actions of every tick as bitmask, together with the seed of the world
+// they were recorded in. Feeding the same actions to a world with the same seed
+// reproduces the session exactly. Stored as a small binary file, one byte per tick.
+class InputRecording
+{
+	public:
+									InputRecording();
+
+		void						reset(sf::Uint64 seed);
+		void						addTick(unsigned int actions);
+
+		sf::Uint64					getSeed() const;
+		std::size_t					getTickCount() const;
+		unsigned int				getActions(std::size_t tick) const;
+
+		bool						saveToFile(const std::string& filename) const;
+		bool						loadFromFile(const std::string& filename);
+
+
+	private:
+		sf::Uint64					mSeed;
+		std::vector<sf::Uint8>		mTicks;
+};
+
+#endif
@@ -0,0 +1,255 @@
+#include "JobSystem.h"
+#include "Foreach.h"
+
+#include <SFML/System/Lock.hpp>
+#include <SFML/System/Sleep.hpp>
+#include <SFML/System/Clock.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <unistd.h>
+#endif
+
+#ifdef _MSC_VER
+	#define THREAD_LOCAL __declspec(thread)
+#else
+	#define THREAD_LOCAL __thread
+#endif
+
+
+namespace
+{
+	// The system and queue of the worker running on this thread, if any
+	THREAD_LOCAL const JobSystem* currentSystem = nullptr;
+	THREAD_LOCAL std::size_t currentQueue = 0;
+}
+
+
+JobSystem::TaskHandle::TaskHandle()
+: mState()
+{
+}
+
+bool JobSystem::TaskHandle::isDone() const
+{
+	if (!mState)
+		return true;
+
+	sf::Lock lock(mState->mutex);
+	return mState->isDone;
+}
+
+JobSystem::JobSystem(std::size_t workerCount)
+: mQueues()
+, mWorkers()
+, mTasks()
+, mMutex()
+, mIsRunning(true)
+{
+	// Queue 0 belongs to the threads calling parallelFor(), the others to one worker each
+	for (std::size_t i = 0; i <= workerCount; ++i)
+		mQueues.push_back(std::unique_ptr<Queue>(new Queue()));
+
+	for (std::size_t i = 0; i < workerCount; ++i)
+	{
+		std::unique_ptr<sf::Thread> worker(new sf::Thread(std::bind(&JobSystem::runWorker, this, i + 1)));
+		worker->launch();
+		mWorkers.push_back(std::move(worker));
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		sf::Lock lock(mMutex);
+		mIsRunning = false;
+	}
+
+	FOREACH(std::unique_ptr<sf::Thread>& worker, mWorkers)
+		worker->wait();
+}
+
+void JobSystem::parallelFor(std::size_t count, std::size_t grainSize, const RangeFunction& function)
+{
+	assert(grainSize > 0);
+
+	std::size_t jobCount = (count + grainSize - 1) / grainSize;
+
+	// Nothing to share: run the ranges right here
+	if (jobCount <= 1 || mWorkers.empty())
+	{
+		for (std::size_t begin = 0; begin < count; begin += grainSize)
+			function(begin, std::min(begin + grainSize, count));
+
+		return;
+	}
+
+	std::shared_ptr<Batch> batch(new Batch());
+	batch->function = &function;
+	batch->pendingJobs = jobCount;
+
+	// Nested calls from a job start with the queue of the worker running it
+	std::size_t ownQueue = getOwnQueue();
+
+	// Deal the ranges out round-robin, so stealing only has to even out the imbalance
+	for (std::size_t i = 0; i < jobCount; ++i)
+	{
+		Job job = { batch, i * grainSize, std::min((i + 1) * grainSize, count) };
+
+		Queue& queue = *mQueues[(ownQueue + i) % mQueues.size()];
+		sf::Lock lock(queue.mutex);
+		queue.jobs.push_back(job);
+	}
+
+	// Help out until the last range is done; may run jobs of other batches meanwhile
+	for (;;)
+	{
+		{
+			sf::Lock lock(batch->mutex);
+			if (batch->pendingJobs == 0)
+				break;
+		}
+
+		if (!runJob(ownQueue))
+			sf::sleep(sf::Time::Zero);
+	}
+}
+
+JobSystem::TaskHandle JobSystem::run(const Task& task)
+{
+	TaskHandle handle;
+
+	// Nobody to hand it to: the task is done by the time the handle is returned
+	if (mWorkers.empty())
+	{
+		task();
+		return handle;
+	}
+
+	handle.mState.reset(new TaskHandle::State());
+	handle.mState->isDone = false;
+
+	PendingTask pending;
+	pending.task = task;
+	pending.handle = handle;
+
+	sf::Lock lock(mMutex);
+	mTasks.push_back(std::move(pending));
+
+	return handle;
+}
+
+std::size_t JobSystem::getThreadCount() const
+{
+	return mWorkers.size() + 1;
+}
+
+std::size_t JobSystem::getHardwareThreadCount()
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return static_cast<std::size_t>(info.dwNumberOfProcessors);
+#else
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? static_cast<std::size_t>(count) : 1;
+#endif
+}
+
+void JobSystem::runWorker(std::size_t index)
+{
+	// Stay responsive for a moment after the last job, then stop burning the core
+	const sf::Time spinTime = sf::milliseconds(2);
+	sf::Clock idleClock;
+
+	currentSystem = this;
+	currentQueue = index;
+
+	while (isRunning())
+	{
+		// Jobs first, someone is waiting for them
+		if (runJob(index) || runTask())
+			idleClock.restart();
+		else if (idleClock.getElapsedTime() < spinTime)
+			sf::sleep(sf::Time::Zero);
+		else
+			sf::sleep(sf::milliseconds(1));
+	}
+}
+
+bool JobSystem::runJob(std::size_t queueIndex)
+{
+	Job job;
+	bool found = false;
+
+	// Newest job of the own deque first, otherwise steal the oldest job of another one
+	for (std::size_t i = 0; i < mQueues.size() && !found; ++i)
+	{
+		Queue& queue = *mQueues[(queueIndex + i) % mQueues.size()];
+		sf::Lock lock(queue.mutex);
+
+		if (queue.jobs.empty())
+			continue;
+
+		if (i == 0)
+		{
+			job = queue.jobs.back();
+			queue.jobs.pop_back();
+		}
+		else
+		{
+			job = queue.jobs.front();
+			queue.jobs.pop_front();
+		}
+
+		found = true;
+	}
+
+	if (!found)
+		return false;
+
+	(*job.batch->function)(job.begin, job.end);
+
+	sf::Lock lock(job.batch->mutex);
+	--job.batch->pendingJobs;
+
+	return true;
+}
+
+bool JobSystem::runTask()
+{
+	PendingTask pending;
+	{
+		sf::Lock lock(mMutex);
+		if (mTasks.empty())
+			return false;
+
+		pending = std::move(mTasks.front());
+		mTasks.pop_front();
+	}
+
+	pending.task();
+
+	sf::Lock lock(pending.handle.mState->mutex);
+	pending.handle.mState->isDone = true;
+
+	return true;
+}
+
+bool JobSystem::isRunning()
+{
+	sf::Lock lock(mMutex);
+	return mIsRunning;
+}
+
+std::size_t JobSystem::getOwnQueue() const
+{
+	// Threads other than this system's workers share queue 0
+	return currentSystem == this ? currentQueue : 0;
+}
@@ -0,0 +1,109 @@
+#ifndef H_JOBSYSTEM
+#define H_JOBSYSTEM
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Thread.hpp>
+#include <SFML/System/Mutex.hpp>
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+
+
+// Small work-stealing scheduler on a fixed set of worker threads. Every thread has its own
+// job deque: it takes its newest job first and steals the oldest one of another thread when
+// its own deque runs dry. The thread waiting in parallelFor() runs jobs as well, so calls may
+// be nested inside jobs. Without workers, everything runs on the calling thread.
+// Longer tasks that nobody waits for, like loading files, go through run(); only workers pick them up.
+class JobSystem : private sf::NonCopyable
+{
+	public:
+		typedef std::function<void(std::size_t begin, std::size_t end)> RangeFunction;
+		typedef std::function<void()> Task;
+
+		// Completion of a task started by run(); copies share the state. An empty handle counts as done.
+		class TaskHandle
+		{
+			friend class JobSystem;
+
+			public:
+										TaskHandle();
+				bool					isDone() const;
+
+
+			private:
+				struct State
+				{
+					bool				isDone;
+					sf::Mutex			mutex;
+				};
+
+
+			private:
+				std::shared_ptr<State>	mState;
+		};
+
+
+	public:
+		explicit					JobSystem(std::size_t workerCount);
+									~JobSystem();
+
+		// Splits [0, count) into ranges of grainSize elements and returns once all of them ran
+		void						parallelFor(std::size_t count, std::size_t grainSize, const RangeFunction& function);
+
+		// Queues the task for the workers and returns at once; tasks still queued on destruction are dropped
+		TaskHandle					run(const Task& task);
+
+		// Workers plus the calling thread
+		std::size_t					getThreadCount() const;
+
+		static std::size_t			getHardwareThreadCount();
+
+
+	private:
+		// Shared by its jobs, so a worker may still unlock it after the caller saw the last one done
+		struct Batch
+		{
+			const RangeFunction*	function;
+			std::size_t				pendingJobs;
+			sf::Mutex				mutex;
+		};
+
+		struct Job
+		{
+			std::shared_ptr<Batch>	batch;
+			std::size_t				begin;
+			std::size_t				end;
+		};
+
+		struct Queue
+		{
+			std::deque<Job>			jobs;
+			sf::Mutex				mutex;
+		};
+
+		struct PendingTask
+		{
+			Task					task;
+			TaskHandle				handle;
+		};
+
+
+	private:
+		void						runWorker(std::size_t index);
+		bool						runJob(std::size_t queueIndex);
+		bool						runTask();
+		bool						isRunning();
+		std::size_t					getOwnQueue() const;
+
+
+	private:
+		std::vector<std::unique_ptr<Queue>>			mQueues;
+		std::vector<std::unique_ptr<sf::Thread>>	mWorkers;
+		std::deque<PendingTask>						mTasks;
+		sf::Mutex									mMutex;
+		bool										mIsRunning;
+};
+
+#endif
@@ -0,0 +1,74 @@
+#include "LoadingState.h"
+#include "FrameSnapshot.h"
+#include "Utility.h"
+#include "World.h"
+#include "AssetCache.h"
+
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/View.hpp>
+
+
+LoadingState::LoadingState(StateStack& stack, Context context)
+: State(stack, context)
+, mLoadingText()
+, mProgressBarBackground()
+, mProgressBar()
+{
+	sf::Font& font = context.assets->getFonts().get(Fonts::Main);
+	sf::Vector2f windowSize(context.window->getSize());
+
+	// In case nobody prefetched, start now; files already loading aren't requested twice
+	World::prefetchAssets(*context.assets, *context.jobs);
+
+	mLoadingText.setFont(font);
+	mLoadingText.setString("Loading");
+	mLoadingText.setCharacterSize(50);
+	centerOrigin(mLoadingText);
+	mLoadingText.setPosition(0.5f * windowSize.x, 0.5f * windowSize.y - 50.f);
+
+	mProgressBarBackground.setFillColor(sf::Color(255, 255, 255, 60));
+	mProgressBarBackground.setSize(sf::Vector2f(windowSize.x - 200.f, 10.f));
+	mProgressBarBackground.setPosition(100.f, 0.5f * windowSize.y + 10.f);
+
+	mProgressBar.setFillColor(sf::Color(100, 100, 100));
+	mProgressBar.setPosition(mProgressBarBackground.getPosition());
+
+	setProgress(0.f);
+}
+
+void LoadingState::draw(FrameSnapshot& frame, float)
+{
+	sf::RenderWindow& window = *getContext().window;
+	frame.setView(window.getDefaultView());
+
+	frame.add(mLoadingText);
+	frame.add(mProgressBarBackground);
+	frame.add(mProgressBar);
+}
+
+bool LoadingState::update(sf::Time)
+{
+	// The application advances the loads every frame, this only watches them
+	Context context = getContext();
+	float progress = World::getAssetProgress(*context.assets);
+	setProgress(progress);
+
+	if (progress >= 1.f)
+	{
+		requestStackPop();
+		requestStackPush(States::Game);
+	}
+
+	return false;
+}
+
+bool LoadingState::handleEvent(const sf::Event&)
+{
+	return false;
+}
+
+void LoadingState::setProgress(float progress)
+{
+	sf::Vector2f size = mProgressBarBackground.getSize();
+	mProgressBar.setSize(sf::Vector2f(size.x * progress, size.y));
+}
@@ -0,0 +1,32 @@
+#ifndef H_LOADINGSTATE
+#define H_LOADINGSTATE
+
+#include "State.h"
+
+#include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/RectangleShape.hpp>
+
+
+// Sits between menu and game and shows the progress of the prefetched game assets.
+// Switches to the game once they are all loaded; if they already are, before anything is drawn.
+class LoadingState : public State
+{
+	public:
+							LoadingState(StateStack& stack, Context context);
+
+		virtual void		draw(FrameSnapshot& frame, float alpha);
+		virtual bool		update(sf::Time dt);
+		virtual bool		handleEvent(const sf::Event& event);
+
+
+	private:
+		void				setProgress(float progress);
+
+
+	private:
+		sf::Text			mLoadingText;
+		sf::RectangleShape	mProgressBarBackground;
+		sf::RectangleShape	mProgressBar;
+};
+
+#endif
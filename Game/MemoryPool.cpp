@@ -0,0 +1,91 @@
+#include "MemoryPool.h"
+#include "Foreach.h"
+
+#include <algorithm>
+#include <new>
+#include <cassert>
+
+
+namespace
+{
+	// Every block is aligned like the start of a slab from operator new
+	const std::size_t BlockAlignment = 16;
+}
+
+MemoryPool::MemoryPool(std::size_t blockSize, std::size_t blocksPerSlab)
+: mBlockSize((std::max(blockSize, sizeof(FreeBlock)) + BlockAlignment - 1) / BlockAlignment * BlockAlignment)
+, mBlocksPerSlab(blocksPerSlab)
+, mSlabs()
+, mFreeList(nullptr)
+, mLiveBlocks(0)
+, mHighWaterMark(0)
+{
+	assert(blocksPerSlab > 0);
+}
+
+MemoryPool::~MemoryPool()
+{
+	FOREACH(char* slab, mSlabs)
+		::operator delete(slab);
+}
+
+void* MemoryPool::allocate(std::size_t size)
+{
+	// Objects of derived classes may not fit into a block, give them ordinary heap memory
+	if (size > mBlockSize)
+		return ::operator new(size);
+
+	if (!mFreeList)
+		addSlab();
+
+	FreeBlock* block = mFreeList;
+	mFreeList = block->next;
+
+	++mLiveBlocks;
+	mHighWaterMark = std::max(mHighWaterMark, mLiveBlocks);
+
+	return block;
+}
+
+void MemoryPool::deallocate(void* block, std::size_t size)
+{
+	if (!block)
+		return;
+
+	if (size > mBlockSize)
+	{
+		::operator delete(block);
+		return;
+	}
+
+	assert(mLiveBlocks > 0);
+	--mLiveBlocks;
+
+	FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+	freeBlock->next = mFreeList;
+	mFreeList = freeBlock;
+}
+
+MemoryPool::Stats MemoryPool::getStats() const
+{
+	Stats stats;
+	stats.liveBlocks = mLiveBlocks;
+	stats.capacity = mSlabs.size() * mBlocksPerSlab;
+	stats.highWaterMark = mHighWaterMark;
+
+	return stats;
+}
+
+void MemoryPool::addSlab()
+{
+	char* slab = static_cast<char*>(::operator new(mBlockSize * mBlocksPerSlab));
+	mSlabs.push_back(slab);
+
+	// Thread the new blocks onto the free list, lowest address first
+	for (std::size_t i = mBlocksPerSlab; i > 0; --i)
+	{
+		FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + (i - 1) * mBlockSize);
+		block->next = mFreeList;
+		mFreeList = block;
+	}
+}
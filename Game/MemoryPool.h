@@ -0,0 +1,54 @@
+#ifndef H_MEMORYPOOL
+#define H_MEMORYPOOL
+
+#include <SFML/System/NonCopyable.hpp>
+
+#include <vector>
+#include <cstddef>
+
+
+// Fixed-size block allocator. Blocks are carved from slabs that are kept for
+// the pool's lifetime, so freed blocks are recycled instead of returned to the heap.
+class MemoryPool : private sf::NonCopyable
+{
+	public:
+		struct Stats
+		{
+			std::size_t				liveBlocks;
+			std::size_t				capacity;
+			std::size_t				highWaterMark;
+		};
+
+
+	public:
+									MemoryPool(std::size_t blockSize, std::size_t blocksPerSlab);
+									~MemoryPool();
+
+		void*						allocate(std::size_t size);
+		void						deallocate(void* block, std::size_t size);
+
+		Stats						getStats() const;
+
+
+	private:
+		struct FreeBlock
+		{
+			FreeBlock*				next;
+		};
+
+
+	private:
+		void						addSlab();
+
+
+	private:
+		std::size_t					mBlockSize;
+		std::size_t					mBlocksPerSlab;
+		std::vector<char*>			mSlabs;
+		FreeBlock*					mFreeList;
+
+		std::size_t					mLiveBlocks;
+		std::size_t					mHighWaterMark;
+};
+
+#endif
@@ -1,7 +1,9 @@
 #include "MenuState.h"
+#include "FrameSnapshot.h"
 #include "Utility.h"
 #include "Foreach.h"
-#include "ResourceHolder.h"
+#include "AssetCache.h"
+#include "World.h"
 
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/View.hpp>
@@ -12,8 +14,8 @@ MenuState::MenuState(StateStack& stack, Context context)
 , mOptions()
 , mOptionIndex(0)
 {
-	sf::Texture& texture = context.textures->get(Textures::TitleScreen);
-	sf::Font& font = context.fonts->get(Fonts::Main);
+	sf::Texture& texture = context.assets->getTextures().get(Textures::TitleScreen);
+	sf::Font& font = context.assets->getFonts().get(Fonts::Main);
 
 	mBackgroundSprite.setTexture(texture);
 	
@@ -22,7 +24,7 @@ MenuState::MenuState(StateStack& stack, Context context)
 	playOption.setFont(font);
 	playOption.setString("Play");
 	playOption.setOrigin(-200, 250);
-	playOption.setPosition(context.window->getView().getSize() / 2.f);
+	playOption.setPosition(context.window->getDefaultView().getSize() / 2.f);
 	mOptions.push_back(playOption);
 
 
@@ -36,15 +38,15 @@ MenuState::MenuState(StateStack& stack, Context context)
 	updateOptionText();
 }
 
-void MenuState::draw()
+void MenuState::draw(FrameSnapshot& frame, float)
 {
 	sf::RenderWindow& window = *getContext().window;
 
-	window.setView(window.getDefaultView());
-	window.draw(mBackgroundSprite);
+	frame.setView(window.getDefaultView());
+	frame.add(mBackgroundSprite);
 
 	FOREACH(const sf::Text& text, mOptions)
-		window.draw(text);
+		frame.add(text);
 }
 
 bool MenuState::update(sf::Time)
@@ -62,8 +64,11 @@ bool MenuState::handleEvent(const sf::Event& event)
 	{
 		if (mOptionIndex == Play)
 		{
+			// Skip the loading screen if there's nothing left to wait for
+			bool isLoaded = World::getAssetProgress(*getContext().assets) >= 1.f;
+
 			requestStackPop();
-			requestStackPush(States::Game);
+			requestStackPush(isLoaded ? States::Game : States::Loading);
 		}
 		else if (mOptionIndex == Exit)
 		{
@@ -1,6 +1,7 @@
 #include "PauseState.h"
+#include "FrameSnapshot.h"
 #include "Utility.h"
-#include "ResourceHolder.h"
+#include "AssetCache.h"
 
 #include <SFML/Graphics/RectangleShape.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
@@ -13,8 +14,8 @@ PauseState::PauseState(StateStack& stack, Context context)
 , mPausedText()
 , mInstructionText()
 {
-	sf::Font& font = context.fonts->get(Fonts::Main);
-	sf::Vector2f viewSize = context.window->getView().getSize();
+	sf::Font& font = context.assets->getFonts().get(Fonts::Main);
+	sf::Vector2f viewSize = context.window->getDefaultView().getSize();
 
 	mPausedText.setFont(font);
 	mPausedText.setString("Game Paused");	
@@ -28,18 +29,18 @@ PauseState::PauseState(StateStack& stack, Context context)
 	mInstructionText.setPosition(0.5f * viewSize.x, 0.6f * viewSize.y);
 }
 
-void PauseState::draw()
+void PauseState::draw(FrameSnapshot& frame, float)
 {
 	sf::RenderWindow& window = *getContext().window;
-	window.setView(window.getDefaultView());
+	frame.setView(window.getDefaultView());
 
 	sf::RectangleShape backgroundShape;
 	backgroundShape.setFillColor(sf::Color(0, 0, 0, 150));
-	backgroundShape.setSize(window.getView().getSize());
+	backgroundShape.setSize(window.getDefaultView().getSize());
 
-	window.draw(backgroundShape);
-	window.draw(mPausedText);
-	window.draw(mInstructionText);
+	frame.add(backgroundShape);
+	frame.add(mPausedText);
+	frame.add(mInstructionText);
 }
 
 bool PauseState::update(sf::Time)
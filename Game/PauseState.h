@@ -12,7 +12,7 @@ class PauseState : public State
 	public:
 							PauseState(StateStack& stack, Context context);
 
-		virtual void		draw();
+		virtual void		draw(FrameSnapshot& frame, float alpha);
 		virtual bool		update(sf::Time dt);
 		virtual bool		handleEvent(const sf::Event& event);
 
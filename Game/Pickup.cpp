@@ -3,7 +3,8 @@
 #include "Category.h"
 #include "CommandQueue.h"
 #include "Utility.h"
-#include "ResourceHolder.h"
+#include "TextureAtlas.h"
+#include "SpriteBatch.h"
 
 #include <SFML/Graphics/RenderTarget.hpp>
 
@@ -11,22 +12,43 @@
 namespace
 {
 	const std::vector<PickupData> Table = initializePickupData();
+
+	MemoryPool& getPool()
+	{
+		static MemoryPool pool(sizeof(Pickup), 64);
+		return pool;
+	}
 }
 
-Pickup::Pickup(Type type, const TextureHolder& textures)
-: Entity(1)
+Pickup::Pickup(HandleTable& handles, Type type, const TextureAtlas& textures)
+: Entity(handles, 1)
 , mType(type)
-, mSprite(textures.get(Table[type].texture))
+, mSprite(textures.createSprite(Table[type].texture))
 {
 	centerOrigin(mSprite);
 }
 
+void* Pickup::operator new(std::size_t size)
+{
+	return getPool().allocate(size);
+}
+
+void Pickup::operator delete(void* block, std::size_t size)
+{
+	getPool().deallocate(block, size);
+}
+
+MemoryPool::Stats Pickup::getPoolStats()
+{
+	return getPool().getStats();
+}
+
 unsigned int Pickup::getCategory() const
 {
 	return Category::Pickup;
 }
 
-sf::FloatRect Pickup::getBoundingRect() const
+sf::FloatRect Pickup::computeBoundingRect() const
 {
 	return getWorldTransform().transformRect(mSprite.getGlobalBounds());
 }
@@ -41,3 +63,8 @@ void Pickup::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) cons
 	target.draw(mSprite, states);
 }
 
+void Pickup::batchCurrent(SpriteBatch& batch) const
+{
+	batch.addSprite(mSprite, getRenderTransform(batch.getInterpolation()));
+}
+
@@ -2,6 +2,7 @@
 #define BOOK_PICKUP_HPP
 
 #include "Entity.h"
+#include "MemoryPool.h"
 #include "Command.h"
 #include "resourceIdentifiers.h"
 
@@ -24,16 +25,22 @@ class Pickup : public Entity
 
 
 	public:
-								Pickup(Type type, const TextureHolder& textures);
+								Pickup(HandleTable& handles, Type type, const TextureAtlas& textures);
+
+		// Storage is recycled through a class-wide memory pool
+		static void*			operator new(std::size_t size);
+		static void				operator delete(void* block, std::size_t size);
+		static MemoryPool::Stats	getPoolStats();
 
 		virtual unsigned int	getCategory() const;
-		virtual sf::FloatRect	getBoundingRect() const;
 
 		void 					apply(Animal& player) const;
 
 
 	protected:
+		virtual sf::FloatRect	computeBoundingRect() const;
 		virtual void			drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+		virtual void			batchCurrent(SpriteBatch& batch) const;
 
 
 	private:
@@ -6,6 +6,8 @@
 #include <map>
 #include <string>
 #include <algorithm>
+#include <functional>
+#include <iostream>
 
 using namespace std::placeholders;
 
@@ -25,6 +27,14 @@ struct AnimalMover
 };
 
 Player::Player()
+: mKeyBinding()
+, mActionBinding()
+, mCurrentMissionStatus(MissionRunning)
+, mActions(0)
+, mRecording()
+, mRecordingFile()
+, mIsReplaying(false)
+, mTick(0)
 {
 	// Set initial key bindings
 	mKeyBinding[sf::Keyboard::Left] = MoveLeft;
@@ -42,28 +52,90 @@ Player::Player()
 		pair.second.category = Category::PlayerAnimal;
 }
 
-void Player::handleEvent(const sf::Event& event, CommandQueue& commands)
+void Player::handleEvent(const sf::Event& event)
 {
 	if (event.type == sf::Event::KeyPressed)
 	{
-		// Check if pressed key appears in key binding, trigger command if so
+		// Check if pressed key appears in key binding, trigger action if so
 		auto found = mKeyBinding.find(event.key.code);
 		if (found != mKeyBinding.end() && !isRealtimeAction(found->second))
-			commands.push(mActionBinding[found->second]);
+			mActions |= 1u << found->second;
 	}
 }
 
-void Player::handleRealtimeInput(CommandQueue& commands)
+void Player::handleRealtimeInput()
 {
 	// Traverse all assigned keys and check if they are pressed
 	FOREACH(auto pair, mKeyBinding)
 	{
-		// If key is pressed, lookup action and trigger corresponding command
+		// If key is pressed, trigger corresponding action
 		if (sf::Keyboard::isKeyPressed(pair.first) && isRealtimeAction(pair.second))
-			commands.push(mActionBinding[pair.second]);
+			mActions |= 1u << pair.second;
 	}
 }
 
+void Player::pushCommands(CommandQueue& commands)
+{
+	unsigned int actions = mActions;
+	mActions = 0;
+
+	// A replay overrides the keyboard; after its last tick the player stays idle
+	if (mIsReplaying)
+		actions = (mTick < mRecording.getTickCount()) ? mRecording.getActions(mTick) : 0u;
+	else if (!mRecordingFile.empty())
+		mRecording.addTick(actions);
+
+	++mTick;
+
+	for (std::size_t action = 0; action < ActionCount; ++action)
+	{
+		if (actions & (1u << action))
+			commands.push(mActionBinding[static_cast<Action>(action)]);
+	}
+}
+
+void Player::recordTo(const std::string& filename)
+{
+	mRecordingFile = filename;
+	mIsReplaying = false;
+}
+
+bool Player::replayFrom(const std::string& filename)
+{
+	if (!mRecording.loadFromFile(filename))
+		return false;
+
+	mRecordingFile.clear();
+	mIsReplaying = true;
+	return true;
+}
+
+bool Player::isReplayFinished() const
+{
+	return mIsReplaying && mTick >= mRecording.getTickCount();
+}
+
+sf::Uint64 Player::startMission(sf::Uint64 seed)
+{
+	mActions = 0;
+	mTick = 0;
+
+	if (mIsReplaying)
+		return mRecording.getSeed();
+
+	mRecording.reset(seed);
+	return seed;
+}
+
+void Player::endMission()
+{
+	if (mRecordingFile.empty())
+		return;
+
+	if (!mRecording.saveToFile(mRecordingFile))
+		std::cout << "Failed to write recording " << mRecordingFile << std::endl;
+}
+
 void Player::assignKey(Action action, sf::Keyboard::Key key)
 {
 	// Remove all keys that already map to action
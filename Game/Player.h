@@ -2,10 +2,12 @@
 #define H_PLAYER
 
 #include "Command.h"
+#include "InputRecording.h"
 
 #include <SFML/Window/Event.hpp>
 
 #include <map>
+#include <string>
 
 
 class CommandQueue;
@@ -35,8 +37,19 @@ class Player
 	public:
 								Player();
 
-		void					handleEvent(const sf::Event& event, CommandQueue& commands);
-		void					handleRealtimeInput(CommandQueue& commands);
+		// Input is collected as action bitmask and turned into commands once per tick
+		void					handleEvent(const sf::Event& event);
+		void					handleRealtimeInput();
+		void					pushCommands(CommandQueue& commands);
+
+		// Missions can be recorded to a file, or replayed from one instead of reading the keyboard
+		void					recordTo(const std::string& filename);
+		bool					replayFrom(const std::string& filename);
+		bool					isReplayFinished() const;
+
+		// Returns the seed for the mission's world; replays use the recorded seed
+		sf::Uint64				startMission(sf::Uint64 seed);
+		void					endMission();
 
 		void					assignKey(Action action, sf::Keyboard::Key key);
 		sf::Keyboard::Key		getAssignedKey(Action action) const;
@@ -53,6 +66,12 @@ class Player
 		std::map<sf::Keyboard::Key, Action>		mKeyBinding;
 		std::map<Action, Command>				mActionBinding;
 		MissionStatus 							mCurrentMissionStatus;
+
+		unsigned int							mActions;
+		InputRecording							mRecording;
+		std::string								mRecordingFile;
+		bool									mIsReplaying;
+		std::size_t								mTick;
 };
 
 #endif 
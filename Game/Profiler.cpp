@@ -0,0 +1,231 @@
+#include "Profiler.h"
+#include "Foreach.h"
+
+#include <fstream>
+#include <cstring>
+#include <cassert>
+
+
+namespace
+{
+	// Weight of the newest frame in the smoothed section times
+	const float AverageWeight = 0.1f;
+}
+
+Profiler& Profiler::getInstance()
+{
+	static Profiler instance;
+	return instance;
+}
+
+Profiler::Profiler()
+: mClock()
+, mFrameStart()
+, mSections()
+, mOpenScopes()
+, mCounters()
+, mFrameHistory(HistorySize)
+, mHistoryIndex(0)
+, mTracing(false)
+, mTraceEvents()
+, mTraceIndex(0)
+, mTraceCount(0)
+{
+}
+
+void Profiler::nextFrame()
+{
+	// Scopes are never open across frames
+	assert(mOpenScopes.empty());
+
+	sf::Time now = mClock.getElapsedTime();
+	mFrameHistory[mHistoryIndex] = now - mFrameStart;
+	mHistoryIndex = (mHistoryIndex + 1) % HistorySize;
+	mFrameStart = now;
+
+	FOREACH(Section& section, mSections)
+	{
+		float average = section.averageTime.asSeconds();
+		average += (section.time.asSeconds() - average) * AverageWeight;
+
+		section.lastFrameTime = section.time;
+		section.averageTime = sf::seconds(average);
+		section.time = sf::Time::Zero;
+	}
+}
+
+void Profiler::enter(const char* name)
+{
+	std::size_t parent = mOpenScopes.empty() ? NoParent : mOpenScopes.back().first;
+	mOpenScopes.push_back(OpenScope(findSection(name, parent), mClock.getElapsedTime()));
+}
+
+void Profiler::leave()
+{
+	assert(!mOpenScopes.empty());
+
+	OpenScope scope = mOpenScopes.back();
+	mOpenScopes.pop_back();
+
+	sf::Time duration = mClock.getElapsedTime() - scope.second;
+	mSections[scope.first].time += duration;
+
+	if (mTracing)
+		recordEvent(mSections[scope.first].name, 'X', scope.second, duration, 0);
+}
+
+void Profiler::setCounter(const char* name, std::size_t value)
+{
+	if (mTracing)
+		recordEvent(name, 'C', mClock.getElapsedTime(), sf::Time::Zero, value);
+
+	FOREACH(Counter& counter, mCounters)
+	{
+		if (std::strcmp(counter.name, name) == 0)
+		{
+			counter.value = value;
+			return;
+		}
+	}
+
+	Counter counter = { name, value };
+	mCounters.push_back(counter);
+}
+
+const std::vector<Profiler::Section>& Profiler::getSections() const
+{
+	return mSections;
+}
+
+const std::vector<Profiler::Counter>& Profiler::getCounters() const
+{
+	return mCounters;
+}
+
+sf::Time Profiler::getFrameTime(std::size_t age) const
+{
+	assert(age < HistorySize);
+	return mFrameHistory[(mHistoryIndex + age) % HistorySize];
+}
+
+sf::Time Profiler::getAverageFrameTime() const
+{
+	sf::Time sum = sf::Time::Zero;
+	FOREACH(sf::Time time, mFrameHistory)
+		sum += time;
+
+	return sum / static_cast<sf::Int64>(HistorySize);
+}
+
+void Profiler::setTracing(bool enabled)
+{
+	// Allocate once, so recording never touches the heap
+	if (enabled && mTraceEvents.empty())
+		mTraceEvents.resize(TraceCapacity);
+
+	if (enabled && !mTracing)
+	{
+		mTraceIndex = 0;
+		mTraceCount = 0;
+	}
+
+	mTracing = enabled;
+}
+
+bool Profiler::isTracing() const
+{
+	return mTracing;
+}
+
+bool Profiler::writeTrace(const std::string& filename) const
+{
+	std::ofstream file(filename.c_str());
+	if (!file)
+		return false;
+
+	// Complete events ('X') for scopes and counter events ('C'), timestamps in microseconds
+	file << "{\"traceEvents\":[";
+
+	std::size_t oldest = (mTraceIndex + TraceCapacity - mTraceCount) % TraceCapacity;
+	for (std::size_t i = 0; i < mTraceCount; ++i)
+	{
+		const TraceEvent& event = mTraceEvents[(oldest + i) % TraceCapacity];
+
+		file << (i == 0 ? "\n" : ",\n")
+			<< "{\"name\":\"" << event.name << "\",\"ph\":\"" << event.phase
+			<< "\",\"ts\":" << event.start.asMicroseconds() << ",\"pid\":0,\"tid\":0";
+
+		if (event.phase == 'X')
+			file << ",\"dur\":" << event.duration.asMicroseconds() << "}";
+		else
+			file << ",\"args\":{\"value\":" << event.value << "}}";
+	}
+
+	file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return static_cast<bool>(file);
+}
+
+std::size_t Profiler::findSection(const char* name, std::size_t parent)
+{
+	for (std::size_t i = 0; i < mSections.size(); ++i)
+	{
+		if (mSections[i].parent == parent && std::strcmp(mSections[i].name, name) == 0)
+			return i;
+	}
+
+	// New sections are inserted after the last descendant of their parent, so the list stays in tree order
+	std::size_t index = mSections.size();
+	if (parent != NoParent)
+	{
+		index = parent + 1;
+		while (index < mSections.size() && mSections[index].depth > mSections[parent].depth)
+			++index;
+	}
+
+	Section section;
+	section.name = name;
+	section.parent = parent;
+	section.depth = (parent == NoParent) ? 0 : mSections[parent].depth + 1;
+	section.time = sf::Time::Zero;
+	section.lastFrameTime = sf::Time::Zero;
+	section.averageTime = sf::Time::Zero;
+
+	// Shift the indices that refer to sections behind the insertion point
+	FOREACH(Section& other, mSections)
+	{
+		if (other.parent != NoParent && other.parent >= index)
+			++other.parent;
+	}
+	FOREACH(OpenScope& scope, mOpenScopes)
+	{
+		if (scope.first >= index)
+			++scope.first;
+	}
+
+	mSections.insert(mSections.begin() + index, section);
+	return index;
+}
+
+void Profiler::recordEvent(const char* name, char phase, sf::Time start, sf::Time duration, std::size_t value)
+{
+	TraceEvent& event = mTraceEvents[mTraceIndex];
+	event.name = name;
+	event.phase = phase;
+	event.start = start;
+	event.duration = duration;
+	event.value = value;
+
+	mTraceIndex = (mTraceIndex + 1) % TraceCapacity;
+	if (mTraceCount < TraceCapacity)
+		++mTraceCount;
+}
+
+ProfileScope::ProfileScope(const char* name)
+{
+	Profiler::getInstance().enter(name);
+}
+
+ProfileScope::~ProfileScope()
+{
+	Profiler::getInstance().leave();
+}
@@ -0,0 +1,122 @@
+#ifndef H_PROFILER
+#define H_PROFILER
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Time.hpp>
+
+#include <vector>
+#include <string>
+#include <utility>
+
+
+// Hierarchical frame profiler. Sections are identified by name and parent, so the same
+// scope reached from different callers shows up once per caller. Times are accumulated
+// per frame; the previous frame and a smoothed average are kept for display.
+// Scopes are only timed if GAME_PROFILING is defined, see PROFILE_SCOPE below.
+// While tracing, every scope and counter update is also recorded as an event in a
+// preallocated ring buffer, which can be written in Chrome's trace event format.
+class Profiler : private sf::NonCopyable
+{
+	public:
+		struct Section
+		{
+			const char*				name;
+			std::size_t				parent;
+			std::size_t				depth;
+			sf::Time				time;
+			sf::Time				lastFrameTime;
+			sf::Time				averageTime;
+		};
+
+		struct Counter
+		{
+			const char*				name;
+			std::size_t				value;
+		};
+
+		static const std::size_t	NoParent = static_cast<std::size_t>(-1);
+		static const std::size_t	HistorySize = 120;
+		static const std::size_t	TraceCapacity = 1 << 16;
+
+
+	public:
+		static Profiler&			getInstance();
+
+		void						nextFrame();
+
+		void						enter(const char* name);
+		void						leave();
+		void						setCounter(const char* name, std::size_t value);
+
+		const std::vector<Section>&	getSections() const;
+		const std::vector<Counter>&	getCounters() const;
+
+		// Frame times of the last HistorySize frames, oldest first
+		sf::Time					getFrameTime(std::size_t age) const;
+		sf::Time					getAverageFrameTime() const;
+
+		// Starting discards the previously recorded events, the oldest ones are overwritten when the buffer is full
+		void						setTracing(bool enabled);
+		bool						isTracing() const;
+		bool						writeTrace(const std::string& filename) const;
+
+
+	private:
+									Profiler();
+
+		std::size_t					findSection(const char* name, std::size_t parent);
+		void						recordEvent(const char* name, char phase, sf::Time start, sf::Time duration, std::size_t value);
+
+
+	private:
+		typedef std::pair<std::size_t, sf::Time> OpenScope;
+
+		struct TraceEvent
+		{
+			const char*				name;
+			char					phase;
+			sf::Time				start;
+			sf::Time				duration;
+			std::size_t				value;
+		};
+
+
+	private:
+		sf::Clock					mClock;
+		sf::Time					mFrameStart;
+
+		std::vector<Section>		mSections;
+		std::vector<OpenScope>		mOpenScopes;
+		std::vector<Counter>		mCounters;
+
+		std::vector<sf::Time>		mFrameHistory;
+		std::size_t					mHistoryIndex;
+
+		bool						mTracing;
+		std::vector<TraceEvent>		mTraceEvents;
+		std::size_t					mTraceIndex;
+		std::size_t					mTraceCount;
+};
+
+// Times the enclosing block as a section of the profiler
+class ProfileScope : private sf::NonCopyable
+{
+	public:
+		explicit					ProfileScope(const char* name);
+									~ProfileScope();
+};
+
+
+#ifdef GAME_PROFILING
+	#define PROFILE_CONCATENATE_IMPL(a, b)	a ## b
+	#define PROFILE_CONCATENATE(a, b)		PROFILE_CONCATENATE_IMPL(a, b)
+
+	#define PROFILE_SCOPE(name)				ProfileScope PROFILE_CONCATENATE(profileScope, __LINE__)(name)
+	#define PROFILE_COUNTER(name, value)	Profiler::getInstance().setCounter(name, value)
+#else
+	#define PROFILE_SCOPE(name)
+	#define PROFILE_COUNTER(name, value)
+#endif
+
+#endif
@@ -0,0 +1,108 @@
+#include "ProfilerOverlay.h"
+#include "Profiler.h"
+#include "Foreach.h"
+#include "FrameSnapshot.h"
+
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+
+namespace
+{
+	const sf::Time	TextUpdateInterval = sf::seconds(0.25f);
+	const sf::Time	FrameBudget = sf::seconds(1.f / 60.f);
+
+	// The graph covers two frame budgets, longer frames are clipped
+	const float		GraphBarWidth = 2.f;
+	const float		GraphHeight = 60.f;
+	const float		GraphLeft = 5.f;
+	const float		GraphTop = 5.f;
+
+	void appendQuad(sf::VertexArray& vertices, sf::FloatRect rect, sf::Color color)
+	{
+		vertices.append(sf::Vertex(sf::Vector2f(rect.left, rect.top), color));
+		vertices.append(sf::Vertex(sf::Vector2f(rect.left + rect.width, rect.top), color));
+		vertices.append(sf::Vertex(sf::Vector2f(rect.left + rect.width, rect.top + rect.height), color));
+		vertices.append(sf::Vertex(sf::Vector2f(rect.left, rect.top + rect.height), color));
+	}
+}
+
+ProfilerOverlay::ProfilerOverlay()
+: mText()
+, mGraph(sf::Quads)
+, mTextUpdateTime()
+{
+	mText.setPosition(GraphLeft, GraphTop + GraphHeight + 5.f);
+	mText.setCharacterSize(16u);
+}
+
+void ProfilerOverlay::setFont(const sf::Font& font)
+{
+	mText.setFont(font);
+}
+
+void ProfilerOverlay::update(sf::Time dt)
+{
+	updateGraph();
+
+	mTextUpdateTime += dt;
+	if (mTextUpdateTime >= TextUpdateInterval)
+	{
+		updateText();
+		mTextUpdateTime = sf::Time::Zero;
+	}
+}
+
+void ProfilerOverlay::draw(FrameSnapshot& frame) const
+{
+	frame.add(mGraph);
+	frame.add(mText);
+}
+
+void ProfilerOverlay::updateText()
+{
+	const Profiler& profiler = Profiler::getInstance();
+	sf::Time frameTime = profiler.getAverageFrameTime();
+
+	std::ostringstream stream;
+	stream << std::fixed << std::setprecision(2);
+
+	stream << "FPS: " << static_cast<int>(1.f / std::max(frameTime.asSeconds(), 0.0001f))
+		<< " (" << frameTime.asSeconds() * 1000.f << " ms)\n";
+
+	// Sections are stored in tree order, indent them by depth
+	FOREACH(const Profiler::Section& section, profiler.getSections())
+	{
+		stream << std::string(2 * section.depth + 2, ' ') << section.name << ": "
+			<< section.averageTime.asSeconds() * 1000.f << " ms\n";
+	}
+
+	FOREACH(const Profiler::Counter& counter, profiler.getCounters())
+		stream << counter.name << ": " << counter.value << "\n";
+
+	mText.setString(stream.str());
+}
+
+void ProfilerOverlay::updateGraph()
+{
+	const Profiler& profiler = Profiler::getInstance();
+	const float scale = GraphHeight / (2.f * FrameBudget.asSeconds());
+
+	mGraph.clear();
+	appendQuad(mGraph, sf::FloatRect(GraphLeft, GraphTop, GraphBarWidth * Profiler::HistorySize, GraphHeight), sf::Color(0, 0, 0, 128));
+
+	// One bar per frame, oldest on the left; frames over budget are red
+	for (std::size_t age = 0; age < Profiler::HistorySize; ++age)
+	{
+		sf::Time frameTime = profiler.getFrameTime(age);
+		float height = std::min(frameTime.asSeconds() * scale, GraphHeight);
+		sf::Color color = (frameTime > FrameBudget) ? sf::Color::Red : sf::Color::Green;
+
+		appendQuad(mGraph, sf::FloatRect(GraphLeft + age * GraphBarWidth, GraphTop + GraphHeight - height, GraphBarWidth, height), color);
+	}
+
+	// Budget line
+	float budgetTop = GraphTop + GraphHeight - FrameBudget.asSeconds() * scale;
+	appendQuad(mGraph, sf::FloatRect(GraphLeft, budgetTop, GraphBarWidth * Profiler::HistorySize, 1.f), sf::Color::White);
+}
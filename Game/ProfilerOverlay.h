@@ -0,0 +1,40 @@
+#ifndef H_PROFILEROVERLAY
+#define H_PROFILEROVERLAY
+
+#include <SFML/System/Time.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/Text.hpp>
+
+
+namespace sf
+{
+	class Font;
+}
+
+class FrameSnapshot;
+
+// Shows the frame rate, a graph of the recent frame times and, if profiling is compiled
+// in, the time of every profiler section and the current counter values.
+// The graph follows every frame, the text is refreshed a few times per second.
+class ProfilerOverlay
+{
+	public:
+								ProfilerOverlay();
+
+		void					setFont(const sf::Font& font);
+		void					update(sf::Time dt);
+		void					draw(FrameSnapshot& frame) const;
+
+
+	private:
+		void					updateText();
+		void					updateGraph();
+
+
+	private:
+		sf::Text				mText;
+		sf::VertexArray			mGraph;
+		sf::Time				mTextUpdateTime;
+};
+
+#endif
@@ -0,0 +1,273 @@
+#include "ProjectileSystem.h"
+#include "CollisionGrid.h"
+#include "DataTables.h"
+#include "Entity.h"
+#include "Foreach.h"
+#include "Utility.h"
+#include "TextureAtlas.h"
+#include "SpriteBatch.h"
+#include "JobSystem.h"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+
+namespace
+{
+	const std::vector<ProjectileData> Table = initializeProjectileData();
+}
+
+ProjectileSystem::ProjectileSystem(HandleTable& handles, const TextureAtlas& textures, JobSystem* jobs)
+: SceneNode(handles)
+, mPositions()
+, mVelocities()
+, mTargetDirections()
+, mTypes()
+, mDamages()
+, mHalfSizes(TypeCount)
+, mTextures(TypeCount)
+, mTextureRects(TypeCount)
+, mCandidates()
+, mHits()
+, mLastStep()
+, mJobs(jobs)
+{
+	for (std::size_t type = 0; type < TypeCount; ++type)
+	{
+		const TextureAtlas::Region& region = textures.get(Table[type].texture);
+		mTextures[type] = region.texture;
+		mTextureRects[type] = region.rect;
+		mHalfSizes[type] = sf::Vector2f(static_cast<float>(region.rect.width), static_cast<float>(region.rect.height)) / 2.f;
+	}
+}
+
+void ProjectileSystem::addProjectile(Type type, sf::Vector2f position, sf::Vector2f velocity)
+{
+	mPositions.push_back(position);
+	mVelocities.push_back(velocity);
+	mTargetDirections.push_back(sf::Vector2f());
+	mTypes.push_back(type);
+	mDamages.push_back(Table[type].damage);
+
+	invalidateBoundingRect();
+}
+
+std::size_t ProjectileSystem::getProjectileCount() const
+{
+	return mPositions.size();
+}
+
+bool ProjectileSystem::isGuided(std::size_t index) const
+{
+	return mTypes[index] == Quack;
+}
+
+sf::Vector2f ProjectileSystem::getPosition(std::size_t index) const
+{
+	return mPositions[index];
+}
+
+void ProjectileSystem::guideTowards(std::size_t index, sf::Vector2f position)
+{
+	assert(isGuided(index));
+	mTargetDirections[index] = unitVector(position - mPositions[index]);
+}
+
+void ProjectileSystem::destroyOutside(sf::FloatRect bounds)
+{
+	for (std::size_t i = 0; i < mPositions.size(); )
+	{
+		if (!bounds.intersects(getBounds(i)))
+			removeProjectile(i);
+		else
+			++i;
+	}
+}
+
+void ProjectileSystem::checkCollisions(const CollisionGrid& grid)
+{
+	// Like collision pairs, all hits are found before any is applied: a projectile damages every
+	// animal it touches that was alive at the start, and is used up if it touched any
+	mHits.clear();
+	for (std::size_t i = 0; i < mPositions.size(); ++i)
+	{
+		grid.query(getBounds(i), Table[mTypes[i]].targets, mCandidates);
+
+		FOREACH(SceneNode* candidate, mCandidates)
+		{
+			if (!candidate->isDestroyed())
+				mHits.push_back(Hit(i, static_cast<Entity*>(candidate)));
+		}
+	}
+
+	FOREACH(const Hit& hit, mHits)
+		hit.second->damage(mDamages[hit.first]);
+
+	// Hits are in projectile order; from the back, only projectiles already checked are swapped into gaps
+	for (auto itr = mHits.rbegin(); itr != mHits.rend(); ++itr)
+	{
+		if (itr == mHits.rbegin() || itr->first != (itr - 1)->first)
+			removeProjectile(itr->first);
+	}
+}
+
+float ProjectileSystem::getMaxSpeed(Type type)
+{
+	return Table[type].speed;
+}
+
+unsigned int ProjectileSystem::getCategory() const
+{
+	return Category::ProjectileSystem;
+}
+
+sf::FloatRect ProjectileSystem::computeBoundingRect() const
+{
+	if (mPositions.empty())
+		return sf::FloatRect();
+
+	sf::FloatRect bounds = getBounds(0);
+	for (std::size_t i = 1; i < mPositions.size(); ++i)
+	{
+		sf::FloatRect rect = getBounds(i);
+		float right = std::max(bounds.left + bounds.width, rect.left + rect.width);
+		float bottom = std::max(bounds.top + bounds.height, rect.top + rect.height);
+
+		bounds.left = std::min(bounds.left, rect.left);
+		bounds.top = std::min(bounds.top, rect.top);
+		bounds.width = right - bounds.left;
+		bounds.height = bottom - bounds.top;
+	}
+
+	return bounds;
+}
+
+void ProjectileSystem::updateCurrent(sf::Time dt, CommandQueue&)
+{
+	const float seconds = dt.asSeconds();
+	mLastStep = dt;
+
+	// Projectiles don't interact with each other, any split of the range gives the same result
+	if (mJobs)
+	{
+		const std::size_t grainSize = 2048;
+		mJobs->parallelFor(mPositions.size(), grainSize, [this, seconds] (std::size_t begin, std::size_t end)
+		{
+			integrate(begin, end, seconds);
+		});
+	}
+	else
+	{
+		integrate(0, mPositions.size(), seconds);
+	}
+
+	invalidateBoundingRect();
+}
+
+void ProjectileSystem::integrate(std::size_t begin, std::size_t end, float seconds)
+{
+	const float approachRate = 200.f;
+
+	for (std::size_t i = begin; i < end; ++i)
+	{
+		if (mTypes[i] == Quack)
+		{
+			sf::Vector2f newVelocity = unitVector(approachRate * seconds * mTargetDirections[i] + mVelocities[i]);
+			mVelocities[i] = newVelocity * Table[Quack].speed;
+		}
+
+		mPositions[i] += mVelocities[i] * seconds;
+	}
+}
+
+void ProjectileSystem::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	// Only used when the scene isn't drawn through a sprite batch
+	SpriteBatch batch;
+	batchCurrent(batch);
+	target.draw(batch, states);
+}
+
+void ProjectileSystem::batchCurrent(SpriteBatch& batch) const
+{
+	// Look the vertex arrays up once per type. Create all of them first, adding a texture to the batch may move the others.
+	for (std::size_t type = 0; type < TypeCount; ++type)
+		batch.getVertices(*mTextures[type]);
+
+	sf::VertexArray* vertexArrays[TypeCount];
+	for (std::size_t type = 0; type < TypeCount; ++type)
+		vertexArrays[type] = &batch.getVertices(*mTextures[type]);
+
+	const float stepBack = 1.f - batch.getInterpolation();
+
+	for (std::size_t i = 0; i < mPositions.size(); ++i)
+	{
+		if (!batch.isVisible(getBounds(i)))
+			continue;
+
+		sf::Vector2f halfSize = mHalfSizes[mTypes[i]];
+		sf::VertexArray& vertices = *vertexArrays[mTypes[i]];
+
+		// Local axes of the sprite; guided projectiles are rotated so that their top points along the velocity
+		sf::Vector2f right(halfSize.x, 0.f);
+		sf::Vector2f down(0.f, halfSize.y);
+		if (isGuided(i))
+		{
+			sf::Vector2f direction = unitVector(mVelocities[i]);
+			right = sf::Vector2f(-direction.y, direction.x) * halfSize.x;
+			down = -direction * halfSize.y;
+		}
+
+		// Step back along the velocity to the interpolated position
+		sf::Vector2f position = mPositions[i] - mVelocities[i] * (stepBack * mLastStep.asSeconds());
+		const sf::IntRect& rect = mTextureRects[mTypes[i]];
+
+		sf::Vector2f texMin(static_cast<float>(rect.left), static_cast<float>(rect.top));
+		sf::Vector2f texMax(static_cast<float>(rect.left + rect.width), static_cast<float>(rect.top + rect.height));
+
+		vertices.append(sf::Vertex(position - right - down, sf::Vector2f(texMin.x, texMin.y)));
+		vertices.append(sf::Vertex(position + right - down, sf::Vector2f(texMax.x, texMin.y)));
+		vertices.append(sf::Vertex(position + right + down, sf::Vector2f(texMax.x, texMax.y)));
+		vertices.append(sf::Vertex(position - right + down, sf::Vector2f(texMin.x, texMax.y)));
+	}
+}
+
+sf::FloatRect ProjectileSystem::getBounds(std::size_t index) const
+{
+	sf::Vector2f halfSize = mHalfSizes[mTypes[index]];
+
+	// Guided projectiles face their flight direction, widen the box accordingly
+	if (isGuided(index))
+	{
+		sf::Vector2f direction = unitVector(mVelocities[index]);
+		halfSize = sf::Vector2f(
+			std::abs(direction.y) * halfSize.x + std::abs(direction.x) * halfSize.y,
+			std::abs(direction.x) * halfSize.x + std::abs(direction.y) * halfSize.y);
+	}
+
+	return sf::FloatRect(mPositions[index] - halfSize, 2.f * halfSize);
+}
+
+void ProjectileSystem::removeProjectile(std::size_t index)
+{
+	// Order doesn't matter, move the last projectile into the gap
+	std::size_t last = mPositions.size() - 1;
+
+	mPositions[index] = mPositions[last];
+	mVelocities[index] = mVelocities[last];
+	mTargetDirections[index] = mTargetDirections[last];
+	mTypes[index] = mTypes[last];
+	mDamages[index] = mDamages[last];
+
+	mPositions.pop_back();
+	mVelocities.pop_back();
+	mTargetDirections.pop_back();
+	mTypes.pop_back();
+	mDamages.pop_back();
+
+	invalidateBoundingRect();
+}
@@ -0,0 +1,83 @@
+#ifndef H_PROJECTILESYSTEM
+#define H_PROJECTILESYSTEM
+
+#include "SceneNode.h"
+#include "resourceIdentifiers.h"
+
+#include <vector>
+#include <utility>
+
+
+class CollisionGrid;
+class JobSystem;
+class Entity;
+
+// Owns every projectile in the world as plain data in parallel arrays.
+// Projectiles are integrated, tested against animals and batched in bulk,
+// instead of living in the scene graph as individual nodes.
+// With a job system, the integration is spread over its threads.
+class ProjectileSystem : public SceneNode
+{
+	public:
+		enum Type
+		{
+			AlliedLaser,
+			EnemyLaser,
+			Quack,
+			TypeCount
+		};
+
+
+	public:
+								ProjectileSystem(HandleTable& handles, const TextureAtlas& textures, JobSystem* jobs);
+
+		void					addProjectile(Type type, sf::Vector2f position, sf::Vector2f velocity);
+		std::size_t				getProjectileCount() const;
+
+		bool					isGuided(std::size_t index) const;
+		sf::Vector2f			getPosition(std::size_t index) const;
+		void					guideTowards(std::size_t index, sf::Vector2f position);
+
+		void					destroyOutside(sf::FloatRect bounds);
+		void					checkCollisions(const CollisionGrid& grid);
+
+		static float			getMaxSpeed(Type type);
+		virtual unsigned int	getCategory() const;
+
+
+	protected:
+		// Covers all projectiles, so the system is culled as a whole once none of them is in view
+		virtual sf::FloatRect	computeBoundingRect() const;
+
+
+	private:
+		typedef std::pair<std::size_t, Entity*> Hit;
+
+
+	private:
+		virtual void			updateCurrent(sf::Time dt, CommandQueue& commands);
+		virtual void			drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+		virtual void			batchCurrent(SpriteBatch& batch) const;
+
+		void					integrate(std::size_t begin, std::size_t end, float seconds);
+		sf::FloatRect			getBounds(std::size_t index) const;
+		void					removeProjectile(std::size_t index);
+
+
+	private:
+		std::vector<sf::Vector2f>	mPositions;
+		std::vector<sf::Vector2f>	mVelocities;
+		std::vector<sf::Vector2f>	mTargetDirections;
+		std::vector<Type>			mTypes;
+		std::vector<int>			mDamages;
+
+		std::vector<sf::Vector2f>		mHalfSizes;
+		std::vector<const sf::Texture*>	mTextures;
+		std::vector<sf::IntRect>		mTextureRects;
+		std::vector<SceneNode*>			mCandidates;
+		std::vector<Hit>				mHits;
+		sf::Time						mLastStep;
+		JobSystem*						mJobs;
+};
+
+#endif
@@ -0,0 +1,91 @@
+#include "Random.h"
+
+#include <cassert>
+
+
+namespace
+{
+	// Spreads the seed over the whole state, so similar seeds give unrelated sequences
+	sf::Uint64 splitMix64(sf::Uint64& state)
+	{
+		sf::Uint64 z = (state += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	sf::Uint32 rotateLeft(sf::Uint32 value, int bits)
+	{
+		return (value << bits) | (value >> (32 - bits));
+	}
+
+	// Maps a 32 bit value to [0, 1) with the full float precision of 24 bits
+	float toUnitFloat(sf::Uint32 value)
+	{
+		return (value >> 8) * (1.f / 16777216.f);
+	}
+}
+
+Random::Random(sf::Uint64 seed)
+{
+	this->seed(seed);
+}
+
+void Random::seed(sf::Uint64 seed)
+{
+	sf::Uint64 a = splitMix64(seed);
+	sf::Uint64 b = splitMix64(seed);
+
+	mState[0] = static_cast<sf::Uint32>(a);
+	mState[1] = static_cast<sf::Uint32>(a >> 32);
+	mState[2] = static_cast<sf::Uint32>(b);
+	mState[3] = static_cast<sf::Uint32>(b >> 32);
+}
+
+sf::Uint32 Random::next()
+{
+	sf::Uint32 result = rotateLeft(mState[1] * 5, 7) * 9;
+	sf::Uint32 t = mState[1] << 9;
+
+	mState[2] ^= mState[0];
+	mState[3] ^= mState[1];
+	mState[1] ^= mState[2];
+	mState[0] ^= mState[3];
+	mState[2] ^= t;
+	mState[3] = rotateLeft(mState[3], 11);
+
+	return result;
+}
+
+int Random::nextInt(int exclusiveMax)
+{
+	assert(exclusiveMax > 0);
+	return static_cast<int>((static_cast<sf::Uint64>(next()) * static_cast<sf::Uint32>(exclusiveMax)) >> 32);
+}
+
+void Random::nextInts(int* values, std::size_t count, int exclusiveMax)
+{
+	assert(exclusiveMax > 0);
+	sf::Uint64 range = static_cast<sf::Uint32>(exclusiveMax);
+
+	for (std::size_t i = 0; i < count; ++i)
+		values[i] = static_cast<int>((next() * range) >> 32);
+}
+
+float Random::nextFloat()
+{
+	return toUnitFloat(next());
+}
+
+float Random::nextFloat(float min, float max)
+{
+	return min + (max - min) * toUnitFloat(next());
+}
+
+void Random::nextFloats(float* values, std::size_t count, float min, float max)
+{
+	float range = max - min;
+
+	for (std::size_t i = 0; i < count; ++i)
+		values[i] = min + range * toUnitFloat(next());
+}
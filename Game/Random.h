@@ -0,0 +1,35 @@
+#ifndef H_RANDOM
+#define H_RANDOM
+
+#include <SFML/Config.hpp>
+
+#include <cstddef>
+
+
+// Small and fast pseudo random number generator (xoshiro128**), 16 bytes of state.
+// Equal seeds produce equal sequences on every platform, so runs can be reproduced.
+// Bounded values use a multiply and shift instead of division and rejection loops;
+// the bias is below 2^-32 * bound, irrelevant for gameplay.
+class Random
+{
+	public:
+		explicit				Random(sf::Uint64 seed);
+
+		void					seed(sf::Uint64 seed);
+		sf::Uint32				next();
+
+		// In [0, exclusiveMax)
+		int						nextInt(int exclusiveMax);
+		void					nextInts(int* values, std::size_t count, int exclusiveMax);
+
+		// In [0, 1) and [min, max)
+		float					nextFloat();
+		float					nextFloat(float min, float max);
+		void					nextFloats(float* values, std::size_t count, float min, float max);
+
+
+	private:
+		sf::Uint32				mState[4];
+};
+
+#endif
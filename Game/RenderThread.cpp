@@ -0,0 +1,128 @@
+#include "RenderThread.h"
+
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/System/Lock.hpp>
+#include <SFML/System/Sleep.hpp>
+
+#include <algorithm>
+
+
+RenderThread::RenderThread(sf::RenderWindow& window)
+: mWindow(window)
+, mThread(&RenderThread::run, this)
+, mMutex()
+, mFrames()
+, mRecordingFrame(0)
+, mReadyFrame(1)
+, mDrawingFrame(2)
+, mHasNewFrame(false)
+, mIsDrawing(false)
+, mStopRequested(false)
+, mIsRunning(false)
+{
+}
+
+RenderThread::~RenderThread()
+{
+	stop();
+}
+
+void RenderThread::start()
+{
+	if (mIsRunning)
+		return;
+
+	mStopRequested = false;
+	mHasNewFrame = false;
+	mIsDrawing = false;
+	mIsRunning = true;
+
+	mWindow.setActive(false);
+	mThread.launch();
+}
+
+void RenderThread::stop()
+{
+	if (!mIsRunning)
+		return;
+
+	{
+		sf::Lock lock(mMutex);
+		mStopRequested = true;
+	}
+
+	mThread.wait();
+	mIsRunning = false;
+
+	mWindow.setActive(true);
+}
+
+bool RenderThread::isRunning() const
+{
+	return mIsRunning;
+}
+
+FrameSnapshot& RenderThread::getRecordingFrame()
+{
+	return mFrames[mRecordingFrame];
+}
+
+void RenderThread::publishFrame()
+{
+	// Replaces a finished frame that wasn't drawn yet; the render thread always shows the latest one
+	sf::Lock lock(mMutex);
+	std::swap(mRecordingFrame, mReadyFrame);
+	mHasNewFrame = true;
+}
+
+void RenderThread::finishFrames()
+{
+	// Polls like the render thread does, SFML has no condition variables
+	while (mIsRunning)
+	{
+		{
+			sf::Lock lock(mMutex);
+			if (!mHasNewFrame && !mIsDrawing)
+				return;
+		}
+
+		sf::sleep(sf::milliseconds(1));
+	}
+}
+
+void RenderThread::run()
+{
+	mWindow.setActive(true);
+
+	for (;;)
+	{
+		{
+			sf::Lock lock(mMutex);
+			if (mStopRequested)
+				break;
+
+			mIsDrawing = mHasNewFrame;
+			if (mHasNewFrame)
+			{
+				std::swap(mDrawingFrame, mReadyFrame);
+				mHasNewFrame = false;
+			}
+		}
+
+		// Don't draw the same frame twice
+		if (!mIsDrawing)
+		{
+			sf::sleep(sf::milliseconds(1));
+			continue;
+		}
+
+		mWindow.clear();
+		mWindow.draw(mFrames[mDrawingFrame]);
+		mWindow.display();
+
+		sf::Lock lock(mMutex);
+		mIsDrawing = false;
+	}
+
+	mWindow.setActive(false);
+}
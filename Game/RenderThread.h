@@ -0,0 +1,59 @@
+#ifndef H_RENDERTHREAD
+#define H_RENDERTHREAD
+
+#include "FrameSnapshot.h"
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Thread.hpp>
+#include <SFML/System/Mutex.hpp>
+
+#include <array>
+
+
+namespace sf
+{
+	class RenderWindow;
+}
+
+// Draws and presents frame snapshots on a thread of its own, so issuing the draw calls and
+// waiting for vertical sync overlap with simulating the next steps. Three snapshots rotate:
+// one is recorded, one is drawn and one holds the latest finished frame. Neither side waits
+// for the other, the mutex only guards swapping the indices.
+class RenderThread : private sf::NonCopyable
+{
+	public:
+		explicit					RenderThread(sf::RenderWindow& window);
+									~RenderThread();
+
+		// The window's GL context moves to the render thread while it runs
+		void						start();
+		void						stop();
+		bool						isRunning() const;
+
+		FrameSnapshot&				getRecordingFrame();
+		void						publishFrame();
+
+		// Blocks until every published frame is drawn, so what they refer to can be freed
+		void						finishFrames();
+
+
+	private:
+		void						run();
+
+
+	private:
+		sf::RenderWindow&				mWindow;
+		sf::Thread						mThread;
+		sf::Mutex						mMutex;
+
+		std::array<FrameSnapshot, 3>	mFrames;
+		std::size_t						mRecordingFrame;
+		std::size_t						mReadyFrame;
+		std::size_t						mDrawingFrame;
+		bool							mHasNewFrame;
+		bool							mIsDrawing;
+		bool							mStopRequested;
+		bool							mIsRunning;
+};
+
+#endif
@@ -1,6 +1,10 @@
 #include "SceneNode.h"
 #include "Foreach.h"
 #include "Command.h"
+#include "CategoryRegistry.h"
+#include "SpriteBatch.h"
+#include "CommandQueue.h"
+#include "JobSystem.h"
 #include "Utility.h"
 
 #include <SFML/Graphics/RectangleShape.hpp>
@@ -11,17 +15,62 @@
 #include <cmath>
 
 
-SceneNode::SceneNode(Category::Type category)
+namespace
+{
+	bool isEmpty(const sf::FloatRect& rect)
+	{
+		return rect.width <= 0.f || rect.height <= 0.f;
+	}
+
+	sf::FloatRect unite(const sf::FloatRect& lhs, const sf::FloatRect& rhs)
+	{
+		float left = std::min(lhs.left, rhs.left);
+		float top = std::min(lhs.top, rhs.top);
+		float right = std::max(lhs.left + lhs.width, rhs.left + rhs.width);
+		float bottom = std::max(lhs.top + lhs.height, rhs.top + rhs.height);
+
+		return sf::FloatRect(left, top, right - left, bottom - top);
+	}
+}
+
+SceneNode::SceneNode(HandleTable& handles, Category::Type category)
 : mChildren()
 , mParent(nullptr)
 , mDefaultCategory(category)
+, mHandles(handles)
+, mHandleId(handles.insert(*this))
+, mCreationSequence(handles.getSequence(mHandleId))
+, mRegistry(nullptr)
+, mRegisteredBit(-1)
+, mPrevInCategory(nullptr)
+, mNextInCategory(nullptr)
+, mGridEntry(-1)
+, mWorldTransform()
+, mBoundingRect()
+, mCullingRect()
+, mWorldTransformDirty(true)
+, mBoundingRectDirty(true)
+, mCullingRectDirty(true)
+{
+}
+
+SceneNode::~SceneNode()
 {
+	// Children unregister themselves when they are destroyed along with mChildren
+	if (mRegistry)
+		mRegistry->remove(*this);
+
+	mHandles.remove(mHandleId);
 }
 
 void SceneNode::attachChild(Ptr child)
 {
 	child->mParent = this;
+	child->invalidateWorldTransform();
+	child->setCategoryRegistry(mRegistry);
 	mChildren.push_back(std::move(child));
+
+	invalidateCullingRect();
 }
 
 SceneNode::Ptr SceneNode::detachChild(const SceneNode& node)
@@ -31,16 +80,79 @@ SceneNode::Ptr SceneNode::detachChild(const SceneNode& node)
 
 	Ptr result = std::move(*found);
 	result->mParent = nullptr;
+	result->invalidateWorldTransform();
+	result->setCategoryRegistry(nullptr);
 	mChildren.erase(found);
+
+	invalidateCullingRect();
 	return result;
 }
 
+void SceneNode::setCategoryRegistry(CategoryRegistry* registry)
+{
+	if (mRegistry == registry)
+		return;
+
+	if (mRegistry)
+		mRegistry->remove(*this);
+
+	mRegistry = registry;
+
+	if (mRegistry)
+		mRegistry->add(*this);
+
+	FOREACH(Ptr& child, mChildren)
+		child->setCategoryRegistry(registry);
+}
+
 void SceneNode::update(sf::Time dt, CommandQueue& commands)
 {
 	updateCurrent(dt, commands);
 	updateChildren(dt, commands);
 }
 
+void SceneNode::updateParallel(sf::Time dt, CommandQueue& commands, JobSystem& jobs, std::vector<CommandQueue>& jobCommands)
+{
+	const std::size_t minChildrenPerJob = 64;
+
+	updateCurrent(dt, commands);
+
+	// Too few children to be worth the jobs, but their subtrees may be
+	if (mChildren.size() < 2 * minChildrenPerJob || jobs.getThreadCount() == 1)
+	{
+		FOREACH(Ptr& child, mChildren)
+			child->updateParallel(dt, commands, jobs, jobCommands);
+
+		return;
+	}
+
+	// The children only write above themselves when they invalidate culling rects, and only read their
+	// parent's world transform. With both prepared here, the jobs don't touch shared nodes. Resources
+	// shared between nodes, like the font behind the labels, must only be used on this thread.
+	invalidateCullingRect();
+	getWorldTransform();
+
+	// A few jobs per thread, so stealing can even out expensive children
+	std::size_t grainSize = std::max(minChildrenPerJob, mChildren.size() / (4 * jobs.getThreadCount()));
+	std::size_t jobCount = (mChildren.size() + grainSize - 1) / grainSize;
+	if (jobCommands.size() < jobCount)
+		jobCommands.resize(jobCount);
+
+	jobs.parallelFor(mChildren.size(), grainSize, [&] (std::size_t begin, std::size_t end)
+	{
+		CommandQueue& queue = jobCommands[begin / grainSize];
+		for (std::size_t i = begin; i < end; ++i)
+			mChildren[i]->update(dt, queue);
+	});
+
+	// Ranges are in child order, so commands end up in the same order as after a sequential update
+	for (std::size_t i = 0; i < jobCount; ++i)
+	{
+		while (!jobCommands[i].isEmpty())
+			commands.push(jobCommands[i].pop());
+	}
+}
+
 void SceneNode::updateCurrent(sf::Time, CommandQueue&)
 {
 	// Do nothing by default
@@ -67,6 +179,42 @@ void SceneNode::drawCurrent(sf::RenderTarget&, sf::RenderStates) const
 	// Do nothing by default
 }
 
+void SceneNode::batchCurrent(SpriteBatch&) const
+{
+	// Do nothing by default
+}
+
+void SceneNode::batchLabelsCurrent(SpriteBatch&) const
+{
+	// Do nothing by default
+}
+
+void SceneNode::fillBatch(SpriteBatch& batch) const
+{
+	// Outside the view, the node is skipped along with everything attached to it; without extent, none of them draws anything
+	sf::FloatRect cullingRect = getCullingRect();
+	if (isEmpty(cullingRect) || !batch.isVisible(cullingRect))
+		return;
+
+	batchCurrent(batch);
+
+	FOREACH(const Ptr& child, mChildren)
+		child->fillBatch(batch);
+}
+
+void SceneNode::fillLabelBatch(SpriteBatch& labels) const
+{
+	// Same culling as fillBatch(), but collects only the labels
+	sf::FloatRect cullingRect = getCullingRect();
+	if (isEmpty(cullingRect) || !labels.isVisible(cullingRect))
+		return;
+
+	batchLabelsCurrent(labels);
+
+	FOREACH(const Ptr& child, mChildren)
+		child->fillLabelBatch(labels);
+}
+
 void SceneNode::drawChildren(sf::RenderTarget& target, sf::RenderStates states) const
 {
 	FOREACH(const Ptr& child, mChildren)
@@ -87,19 +235,143 @@ void SceneNode::drawBoundingRect(sf::RenderTarget& target, sf::RenderStates) con
 	target.draw(shape);
 }
 
+void SceneNode::setPosition(float x, float y)
+{
+	sf::Transformable::setPosition(x, y);
+	invalidateWorldTransform();
+}
+
+void SceneNode::setPosition(const sf::Vector2f& position)
+{
+	sf::Transformable::setPosition(position);
+	invalidateWorldTransform();
+}
+
+void SceneNode::setRotation(float angle)
+{
+	sf::Transformable::setRotation(angle);
+	invalidateWorldTransform();
+}
+
+void SceneNode::setScale(float factorX, float factorY)
+{
+	sf::Transformable::setScale(factorX, factorY);
+	invalidateWorldTransform();
+}
+
+void SceneNode::setScale(const sf::Vector2f& factors)
+{
+	sf::Transformable::setScale(factors);
+	invalidateWorldTransform();
+}
+
+void SceneNode::setOrigin(float x, float y)
+{
+	sf::Transformable::setOrigin(x, y);
+	invalidateWorldTransform();
+}
+
+void SceneNode::setOrigin(const sf::Vector2f& origin)
+{
+	sf::Transformable::setOrigin(origin);
+	invalidateWorldTransform();
+}
+
+void SceneNode::move(float offsetX, float offsetY)
+{
+	sf::Transformable::move(offsetX, offsetY);
+	invalidateWorldTransform();
+}
+
+void SceneNode::move(const sf::Vector2f& offset)
+{
+	sf::Transformable::move(offset);
+	invalidateWorldTransform();
+}
+
+void SceneNode::rotate(float angle)
+{
+	sf::Transformable::rotate(angle);
+	invalidateWorldTransform();
+}
+
+void SceneNode::scale(float factorX, float factorY)
+{
+	sf::Transformable::scale(factorX, factorY);
+	invalidateWorldTransform();
+}
+
+void SceneNode::scale(const sf::Vector2f& factor)
+{
+	sf::Transformable::scale(factor);
+	invalidateWorldTransform();
+}
+
+HandleTable::Id SceneNode::getHandleId() const
+{
+	return mHandleId;
+}
+
+HandleTable& SceneNode::getHandleTable() const
+{
+	return mHandles;
+}
+
+sf::Uint64 SceneNode::getCreationSequence() const
+{
+	return mCreationSequence;
+}
+
 sf::Vector2f SceneNode::getWorldPosition() const
 {
 	return getWorldTransform() * sf::Vector2f();
 }
 
-sf::Transform SceneNode::getWorldTransform() const
+const sf::Transform& SceneNode::getWorldTransform() const
+{
+	// Recompute lazily; the parent's cache is refreshed on the way up if needed
+	if (mWorldTransformDirty)
+	{
+		if (mParent)
+			mWorldTransform = mParent->getWorldTransform() * getTransform();
+		else
+			mWorldTransform = getTransform();
+
+		mWorldTransformDirty = false;
+	}
+
+	return mWorldTransform;
+}
+
+sf::Transform SceneNode::getRenderTransform(float alpha) const
 {
-	sf::Transform transform = sf::Transform::Identity;
+	// At the end of the update step, rendering and simulation agree
+	if (alpha >= 1.f)
+		return getWorldTransform();
 
-	for (const SceneNode* node = this; node != nullptr; node = node->mParent)
-		transform = node->getTransform() * transform;
+	sf::Transform transform = mParent ? mParent->getRenderTransform(alpha) : sf::Transform::Identity;
+	transform.translate(getRenderOffset(alpha));
 
-	return transform;
+	return transform * getTransform();
+}
+
+sf::Vector2f SceneNode::getRenderOffset(float) const
+{
+	return sf::Vector2f();
+}
+
+void SceneNode::invalidateWorldTransform()
+{
+	invalidateBoundingRect();
+
+	// A dirty node always has a dirty subtree, so propagation can stop here
+	if (mWorldTransformDirty)
+		return;
+
+	mWorldTransformDirty = true;
+
+	FOREACH(Ptr& child, mChildren)
+		child->invalidateWorldTransform();
 }
 
 void SceneNode::onCommand(const Command& command, sf::Time dt)
@@ -119,36 +391,73 @@ unsigned int SceneNode::getCategory() const
 }
 
 
-void SceneNode::checkSceneCollision(SceneNode& sceneGraph, std::set<Pair>& collisionPairs)
+void SceneNode::removeWrecks()
 {
-	checkNodeCollision(sceneGraph, collisionPairs);
+	// Remove all children which request so
+	auto wreckfieldBegin = std::remove_if(mChildren.begin(), mChildren.end(), std::mem_fn(&SceneNode::isMarkedForRemoval));
+	if (wreckfieldBegin != mChildren.end())
+	{
+		mChildren.erase(wreckfieldBegin, mChildren.end());
+		invalidateCullingRect();
+	}
 
-	FOREACH(Ptr& child, sceneGraph.mChildren)
-		checkSceneCollision(*child, collisionPairs);
+	// Call function recursively for all remaining children
+	std::for_each(mChildren.begin(), mChildren.end(), std::mem_fn(&SceneNode::removeWrecks));
 }
 
-void SceneNode::checkNodeCollision(SceneNode& node, std::set<Pair>& collisionPairs)
+sf::FloatRect SceneNode::getBoundingRect() const
 {
-	if (this != &node && collision(*this, node) && !isDestroyed() && !node.isDestroyed())
-		collisionPairs.insert(std::minmax(this, &node));
+	if (mBoundingRectDirty)
+	{
+		// Refresh the world transform first, so invalidation keeps reaching this node
+		getWorldTransform();
 
-	FOREACH(Ptr& child, mChildren)
-		child->checkNodeCollision(node, collisionPairs);
+		mBoundingRect = computeBoundingRect();
+		mBoundingRectDirty = false;
+	}
+
+	return mBoundingRect;
 }
 
-void SceneNode::removeWrecks()
+sf::FloatRect SceneNode::computeBoundingRect() const
 {
-	// Remove all children which request so
-	auto wreckfieldBegin = std::remove_if(mChildren.begin(), mChildren.end(), std::mem_fn(&SceneNode::isMarkedForRemoval));
-	mChildren.erase(wreckfieldBegin, mChildren.end());
+	return sf::FloatRect();
+}
 
-	// Call function recursively for all remaining children
-	std::for_each(mChildren.begin(), mChildren.end(), std::mem_fn(&SceneNode::removeWrecks));
+void SceneNode::invalidateBoundingRect()
+{
+	mBoundingRectDirty = true;
+	invalidateCullingRect();
 }
 
-sf::FloatRect SceneNode::getBoundingRect() const
+void SceneNode::invalidateCullingRect()
 {
-	return sf::FloatRect();
+	// Ancestors of a dirty culling rect are always dirty as well
+	for (SceneNode* node = this; node != nullptr && !node->mCullingRectDirty; node = node->mParent)
+		node->mCullingRectDirty = true;
+}
+
+sf::FloatRect SceneNode::getCullingRect() const
+{
+	// Bounds of the node and its attachments. Whatever has no extent (layers, empty texts) adds nothing;
+	// every child is visited, so none stays dirty below a clean parent.
+	if (mCullingRectDirty)
+	{
+		mCullingRect = getBoundingRect();
+
+		FOREACH(const Ptr& child, mChildren)
+		{
+			sf::FloatRect childRect = child->getCullingRect();
+			if (isEmpty(childRect))
+				continue;
+
+			mCullingRect = isEmpty(mCullingRect) ? childRect : unite(mCullingRect, childRect);
+		}
+
+		mCullingRectDirty = false;
+	}
+
+	return mCullingRect;
 }
 
 bool SceneNode::isMarkedForRemoval() const
@@ -2,6 +2,7 @@
 #define H_SCENENODE
 
 #include "Category.h"
+#include "HandleTable.h"
 
 #include <SFML/System/NonCopyable.hpp>
 #include <SFML/System/Time.hpp>
@@ -10,48 +11,101 @@
 
 #include <vector>
 #include <memory>
-#include <set>
 #include <utility>
 
 
 struct Command;
 class CommandQueue;
+class CategoryRegistry;
+class SpriteBatch;
+class JobSystem;
 
-class SceneNode : public sf::Transformable, public sf::Drawable, private sf::NonCopyable
+class SceneNode : private sf::Transformable, public sf::Drawable, private sf::NonCopyable
 {
+	friend class CategoryRegistry;
+	friend class CollisionGrid;
+
 	public:
 		typedef std::unique_ptr<SceneNode> Ptr;
 		typedef std::pair<SceneNode*, SceneNode*> Pair;
 
 
 	public:
-								SceneNode(Category::Type category = Category::None);
+		explicit				SceneNode(HandleTable& handles, Category::Type category = Category::None);
+		virtual					~SceneNode();
 
 		void					attachChild(Ptr child);
 		Ptr						detachChild(const SceneNode& node);
+		void					setCategoryRegistry(CategoryRegistry* registry);
 		
 		void					update(sf::Time dt, CommandQueue& commands);
 
+		// Like update(), but large sets of siblings are split into jobs. Their commands are gathered
+		// in one queue per job and appended in child order, so the outcome is the same as update()'s.
+		void					updateParallel(sf::Time dt, CommandQueue& commands, JobSystem& jobs, std::vector<CommandQueue>& jobCommands);
+		void					fillBatch(SpriteBatch& batch) const;
+		void					fillLabelBatch(SpriteBatch& labels) const;
+
+		// sf::Transformable is private, so every local transform change goes through these and invalidates the cached world transforms
+		void					setPosition(float x, float y);
+		void					setPosition(const sf::Vector2f& position);
+		void					setRotation(float angle);
+		void					setScale(float factorX, float factorY);
+		void					setScale(const sf::Vector2f& factors);
+		void					setOrigin(float x, float y);
+		void					setOrigin(const sf::Vector2f& origin);
+		void					move(float offsetX, float offsetY);
+		void					move(const sf::Vector2f& offset);
+		void					rotate(float angle);
+		void					scale(float factorX, float factorY);
+		void					scale(const sf::Vector2f& factor);
+
+		using					sf::Transformable::getPosition;
+		using					sf::Transformable::getRotation;
+		using					sf::Transformable::getScale;
+		using					sf::Transformable::getOrigin;
+		using					sf::Transformable::getTransform;
+		using					sf::Transformable::getInverseTransform;
+
+		// The node is in the handle table of the world that created it for as long as it lives
+		HandleTable::Id			getHandleId() const;
+		HandleTable&			getHandleTable() const;
+
+		// Order of creation within the world; unlike addresses and handle slots, the same in every run
+		sf::Uint64				getCreationSequence() const;
+
 		sf::Vector2f			getWorldPosition() const;
-		sf::Transform			getWorldTransform() const;
+		const sf::Transform&	getWorldTransform() const;
+		sf::Transform			getRenderTransform(float alpha) const;
 
 		void					onCommand(const Command& command, sf::Time dt);
 		virtual unsigned int	getCategory() const;
 
-		void					checkSceneCollision(SceneNode& sceneGraph, std::set<Pair>& collisionPairs);
-		void					checkNodeCollision(SceneNode& node, std::set<Pair>& collisionPairs);
 		void					removeWrecks();
-		virtual sf::FloatRect	getBoundingRect() const;
+		sf::FloatRect			getBoundingRect() const;
 		virtual bool			isMarkedForRemoval() const;
 		virtual bool			isDestroyed() const;
 
 
+	protected:
+		virtual sf::FloatRect	computeBoundingRect() const;
+		void					invalidateBoundingRect();
+
+		// Offset from the current position to where the node was at the given point of the last update
+		virtual sf::Vector2f	getRenderOffset(float alpha) const;
+
+
 	private:
+		void					invalidateWorldTransform();
+		void					invalidateCullingRect();
+		sf::FloatRect			getCullingRect() const;
 		virtual void			updateCurrent(sf::Time dt, CommandQueue& commands);
 		void					updateChildren(sf::Time dt, CommandQueue& commands);
 
 		virtual void			draw(sf::RenderTarget& target, sf::RenderStates states) const;
 		virtual void			drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+		virtual void			batchCurrent(SpriteBatch& batch) const;
+		virtual void			batchLabelsCurrent(SpriteBatch& labels) const;
 		void					drawChildren(sf::RenderTarget& target, sf::RenderStates states) const;
 		void					drawBoundingRect(sf::RenderTarget& target, sf::RenderStates states) const;
 
@@ -60,6 +114,22 @@ class SceneNode : public sf::Transformable, public sf::Drawable, private sf::Non
 		std::vector<Ptr>		mChildren;
 		SceneNode*				mParent;
 		Category::Type			mDefaultCategory;
+		HandleTable&			mHandles;
+		HandleTable::Id			mHandleId;
+		sf::Uint64				mCreationSequence;
+
+		CategoryRegistry*		mRegistry;
+		int						mRegisteredBit;
+		SceneNode*				mPrevInCategory;
+		SceneNode*				mNextInCategory;
+		int						mGridEntry;
+
+		mutable sf::Transform	mWorldTransform;
+		mutable sf::FloatRect	mBoundingRect;
+		mutable sf::FloatRect	mCullingRect;
+		mutable bool			mWorldTransformDirty;
+		mutable bool			mBoundingRectDirty;
+		mutable bool			mCullingRectDirty;
 };
 
 bool	collision(const SceneNode& lhs, const SceneNode& rhs);
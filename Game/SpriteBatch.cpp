@@ -0,0 +1,130 @@
+#include "SpriteBatch.h"
+#include "Foreach.h"
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <cassert>
+
+
+SpriteBatch::SpriteBatch()
+: mBatches()
+, mViewBounds()
+, mCullStats()
+, mInterpolation(1.f)
+{
+	mCullStats.drawn = 0;
+	mCullStats.culled = 0;
+}
+
+void SpriteBatch::setViewBounds(sf::FloatRect viewBounds)
+{
+	// Called once per frame, the counters cover all layers drawn with this view
+	mViewBounds = viewBounds;
+	mCullStats.drawn = 0;
+	mCullStats.culled = 0;
+}
+
+bool SpriteBatch::isVisible(sf::FloatRect bounds)
+{
+	// Without a view nothing is culled, and neither is anything without an extent
+	bool hasExtent = bounds.width > 0.f && bounds.height > 0.f;
+	bool hasView = mViewBounds.width > 0.f && mViewBounds.height > 0.f;
+
+	if (hasExtent && hasView && !mViewBounds.intersects(bounds))
+	{
+		++mCullStats.culled;
+		return false;
+	}
+
+	++mCullStats.drawn;
+	return true;
+}
+
+const SpriteBatch::CullStats& SpriteBatch::getCullStats() const
+{
+	return mCullStats;
+}
+
+void SpriteBatch::setInterpolation(float alpha)
+{
+	mInterpolation = alpha;
+}
+
+float SpriteBatch::getInterpolation() const
+{
+	return mInterpolation;
+}
+
+void SpriteBatch::clear()
+{
+	// Keep the batches and their capacity, the same textures come back next frame
+	FOREACH(Batch& batch, mBatches)
+		batch.vertices.clear();
+}
+
+void SpriteBatch::addSprite(const sf::Sprite& sprite, const sf::Transform& transform)
+{
+	assert(sprite.getTexture() != nullptr);
+
+	sf::VertexArray& vertices = getVertices(*sprite.getTexture());
+	sf::Transform combined = transform * sprite.getTransform();
+
+	sf::FloatRect bounds = sprite.getLocalBounds();
+	sf::IntRect textureRect = sprite.getTextureRect();
+	sf::Color color = sprite.getColor();
+
+	float left = static_cast<float>(textureRect.left);
+	float top = static_cast<float>(textureRect.top);
+	float right = left + textureRect.width;
+	float bottom = top + textureRect.height;
+
+	vertices.append(sf::Vertex(combined.transformPoint(0.f, 0.f), color, sf::Vector2f(left, top)));
+	vertices.append(sf::Vertex(combined.transformPoint(bounds.width, 0.f), color, sf::Vector2f(right, top)));
+	vertices.append(sf::Vertex(combined.transformPoint(bounds.width, bounds.height), color, sf::Vector2f(right, bottom)));
+	vertices.append(sf::Vertex(combined.transformPoint(0.f, bounds.height), color, sf::Vector2f(left, bottom)));
+}
+
+sf::VertexArray& SpriteBatch::getVertices(const sf::Texture& texture)
+{
+	// A handful of textures per frame, a linear search is fine
+	FOREACH(Batch& batch, mBatches)
+	{
+		if (batch.texture == &texture)
+			return batch.vertices;
+	}
+
+	Batch batch;
+	batch.texture = &texture;
+	batch.vertices.setPrimitiveType(sf::Quads);
+	mBatches.push_back(batch);
+
+	return mBatches.back().vertices;
+}
+
+std::size_t SpriteBatch::getDrawCallCount() const
+{
+	// One call per non-empty batch
+	std::size_t count = 0;
+	FOREACH(const Batch& batch, mBatches)
+	{
+		if (batch.vertices.getVertexCount() != 0)
+			++count;
+	}
+
+	return count;
+}
+
+void SpriteBatch::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	// Textures are drawn in the order they were first used
+	FOREACH(const Batch& batch, mBatches)
+	{
+		if (batch.vertices.getVertexCount() == 0)
+			continue;
+
+		states.texture = batch.texture;
+		target.draw(batch.vertices, states);
+	}
+}
@@ -0,0 +1,70 @@
+#ifndef H_SPRITEBATCH
+#define H_SPRITEBATCH
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+#include <vector>
+
+
+namespace sf
+{
+	class Sprite;
+	class Texture;
+}
+
+// Collects textured quads in world coordinates, one vertex array per texture,
+// and draws each texture with a single draw call.
+// Also culls against the view bounds and counts what was drawn and culled.
+class SpriteBatch : public sf::Drawable, private sf::NonCopyable
+{
+	public:
+		struct CullStats
+		{
+			std::size_t					drawn;
+			std::size_t					culled;
+		};
+
+
+	public:
+										SpriteBatch();
+
+		void							setViewBounds(sf::FloatRect viewBounds);
+		bool							isVisible(sf::FloatRect bounds);
+		const CullStats&				getCullStats() const;
+
+		// Where between the previous and the current update the nodes are drawn, in [0, 1]
+		void							setInterpolation(float alpha);
+		float							getInterpolation() const;
+
+		void							clear();
+		void							addSprite(const sf::Sprite& sprite, const sf::Transform& transform);
+		sf::VertexArray&				getVertices(const sf::Texture& texture);
+
+		std::size_t						getDrawCallCount() const;
+
+
+	private:
+		struct Batch
+		{
+			const sf::Texture*			texture;
+			sf::VertexArray				vertices;
+		};
+
+
+	private:
+		virtual void					draw(sf::RenderTarget& target, sf::RenderStates states) const;
+
+
+	private:
+		std::vector<Batch>				mBatches;
+
+		sf::FloatRect					mViewBounds;
+		CullStats						mCullStats;
+		float							mInterpolation;
+};
+
+#endif
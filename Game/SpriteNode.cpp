@@ -1,19 +1,32 @@
 #include "SpriteNode.h"
+#include "SpriteBatch.h"
 
 #include <SFML/Graphics/RenderTarget.hpp>
 
 
-SpriteNode::SpriteNode(const sf::Texture& texture)
-: mSprite(texture)
+SpriteNode::SpriteNode(HandleTable& handles, const sf::Texture& texture)
+: SceneNode(handles)
+, mSprite(texture)
 {
 }	
 
-SpriteNode::SpriteNode(const sf::Texture& texture, const sf::IntRect& textureRect)
-: mSprite(texture, textureRect)
+SpriteNode::SpriteNode(HandleTable& handles, const sf::Texture& texture, const sf::IntRect& textureRect)
+: SceneNode(handles)
+, mSprite(texture, textureRect)
 {
 }
 
+sf::FloatRect SpriteNode::computeBoundingRect() const
+{
+	return getWorldTransform().transformRect(mSprite.getGlobalBounds());
+}
+
 void SpriteNode::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
 {
 	target.draw(mSprite, states);
+}
+
+void SpriteNode::batchCurrent(SpriteBatch& batch) const
+{
+	batch.addSprite(mSprite, getRenderTransform(batch.getInterpolation()));
 }
\ No newline at end of file
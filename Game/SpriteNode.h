@@ -9,12 +9,17 @@
 class SpriteNode : public SceneNode
 {
 	public:
-		explicit			SpriteNode(const sf::Texture& texture);
-							SpriteNode(const sf::Texture& texture, const sf::IntRect& textureRect);
+							SpriteNode(HandleTable& handles, const sf::Texture& texture);
+							SpriteNode(HandleTable& handles, const sf::Texture& texture, const sf::IntRect& textureRect);
+
+
+	protected:
+		virtual sf::FloatRect	computeBoundingRect() const;
 
 
 	private:
 		virtual void		drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+		virtual void		batchCurrent(SpriteBatch& batch) const;
 
 
 	private:
@@ -2,11 +2,11 @@
 #include "StateStack.h"
 
 
-State::Context::Context(sf::RenderWindow& window, TextureHolder& textures, FontHolder& fonts, Player& player)
+State::Context::Context(sf::RenderWindow& window, AssetCache& assets, Player& player, JobSystem& jobs)
 : window(&window)
-, textures(&textures)
-, fonts(&fonts)
+, assets(&assets)
 , player(&player)
+, jobs(&jobs)
 {
 }
 
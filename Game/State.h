@@ -2,7 +2,7 @@
 #define H_STATE
 
 #include "StateIdentifiers.h"
-#include "ResourceIdentifiers.h"
+#include "resourceIdentifiers.h"
 
 #include <SFML/System/Time.hpp>
 #include <SFML/Window/Event.hpp>
@@ -16,7 +16,10 @@ namespace sf
 }
 
 class StateStack;
+class AssetCache;
 class Player;
+class JobSystem;
+class FrameSnapshot;
 
 class State
 {
@@ -25,12 +28,12 @@ class State
 
 		struct Context
 		{
-								Context(sf::RenderWindow& window, TextureHolder& textures, FontHolder& fonts, Player& player);
+								Context(sf::RenderWindow& window, AssetCache& assets, Player& player, JobSystem& jobs);
 
 			sf::RenderWindow*	window;
-			TextureHolder*		textures;
-			FontHolder*			fonts;
+			AssetCache*			assets;
 			Player*				player;
+			JobSystem*			jobs;
 		};
 
 
@@ -38,7 +41,8 @@ class State
 							State(StateStack& stack, Context context);
 		virtual				~State();
 
-		virtual void		draw() = 0;
+		// Records what to draw into the frame; alpha is the fraction of a time step that passed since the last update
+		virtual void		draw(FrameSnapshot& frame, float alpha) = 0;
 		virtual bool		update(sf::Time dt) = 0;
 		virtual bool		handleEvent(const sf::Event& event) = 0;
 
@@ -9,6 +9,7 @@ namespace States
 		None,
 		Title,
 		Menu,
+		Loading,
 		Game,
 		Pause,
 		GameOver
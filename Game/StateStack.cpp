@@ -1,6 +1,8 @@
 #include "StateStack.h"
 #include "Foreach.h"
+#include "Profiler.h"
 
+#include <iterator>
 #include <cassert>
 
 
@@ -9,26 +11,36 @@ StateStack::StateStack(State::Context context)
 , mPendingList()
 , mContext(context)
 , mFactories()
+, mFrozenStateCount(0)
+, mBeforeChange()
 {
 }
 
 void StateStack::update(sf::Time dt)
 {
-	// Iterate from top to bottom, stop as soon as update() returns false
+	PROFILE_SCOPE("StateStack::update");
+
+	// Iterate from top to bottom, stop as soon as update() returns false; the states below are frozen
+	mFrozenStateCount = 0;
 	for (auto itr = mStack.rbegin(); itr != mStack.rend(); ++itr)
 	{
 		if (!(*itr)->update(dt))
+		{
+			mFrozenStateCount = std::distance(itr, mStack.rend()) - 1;
 			break;
+		}
 	}
 
 	applyPendingChanges();
 }
 
-void StateStack::draw()
+void StateStack::draw(FrameSnapshot& frame, float alpha)
 {
-	// Draw all active states from bottom to top
-	FOREACH(State::Ptr& state, mStack)
-		state->draw();
+	PROFILE_SCOPE("StateStack::draw");
+
+	// Draw all active states from bottom to top; frozen states are where their last update left them
+	for (std::size_t i = 0; i < mStack.size(); ++i)
+		mStack[i]->draw(frame, i < mFrozenStateCount ? 1.f : alpha);
 }
 
 void StateStack::handleEvent(const sf::Event& event)
@@ -63,6 +75,11 @@ bool StateStack::isEmpty() const
 	return mStack.empty();
 }
 
+void StateStack::setBeforeChangeCallback(std::function<void()> callback)
+{
+	mBeforeChange = callback;
+}
+
 State::Ptr StateStack::createState(States::ID stateID)
 {
 	auto found = mFactories.find(stateID);
@@ -73,6 +90,9 @@ State::Ptr StateStack::createState(States::ID stateID)
 
 void StateStack::applyPendingChanges()
 {
+	if (!mPendingList.empty() && mBeforeChange)
+		mBeforeChange();
+
 	FOREACH(PendingChange change, mPendingList)
 	{
 		switch (change.action)
@@ -87,6 +107,7 @@ void StateStack::applyPendingChanges()
 
 			case Clear:
 				mStack.clear();
+				mFrozenStateCount = 0;
 				break;
 		}
 	}
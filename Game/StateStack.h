@@ -3,7 +3,7 @@
 
 #include "State.h"
 #include "StateIdentifiers.h"
-#include "ResourceIdentifiers.h"
+#include "resourceIdentifiers.h"
 
 #include <SFML/System/NonCopyable.hpp>
 #include <SFML/System/Time.hpp>
@@ -38,7 +38,7 @@ class StateStack : private sf::NonCopyable
 		void				registerState(States::ID stateID);
 
 		void				update(sf::Time dt);
-		void				draw();
+		void				draw(FrameSnapshot& frame, float alpha);
 		void				handleEvent(const sf::Event& event);
 
 		void				pushState(States::ID stateID);
@@ -47,6 +47,9 @@ class StateStack : private sf::NonCopyable
 
 		bool				isEmpty() const;
 
+		// Called before pending changes are applied, while the states and their resources still exist
+		void				setBeforeChangeCallback(std::function<void()> callback);
+
 
 	private:
 		State::Ptr			createState(States::ID stateID);
@@ -69,6 +72,8 @@ class StateStack : private sf::NonCopyable
 
 		State::Context										mContext;
 		std::map<States::ID, std::function<State::Ptr()>>	mFactories;
+		std::size_t											mFrozenStateCount;
+		std::function<void()>								mBeforeChange;
 };
 
 
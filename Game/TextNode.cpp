@@ -1,24 +1,98 @@
 #include "TextNode.h"
+#include "SpriteBatch.h"
+#include "Foreach.h"
 #include "Utility.h"
 
 #include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
 
-    
-TextNode::TextNode(const FontHolder& fonts, const std::string& text)
+#include <cmath>
+
+
+namespace
 {
-	mText.setFont(fonts.get(Fonts::Main));
-	mText.setCharacterSize(20);
-	mText.setColor(sf::Color::Black);
-	setString(text);
+	const unsigned int	CharacterSize = 20;
+	const sf::Color		TextColor = sf::Color::Black;
 }
 
-void TextNode::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+TextNode::TextNode(HandleTable& handles, const FontHolder& fonts, const std::string& text)
+: SceneNode(handles)
+, mFont(fonts.get(Fonts::Main))
+, mString(text)
+, mVertices(sf::Quads)
+, mLocalBounds()
+, mGeometryChanged(true)
 {
-	target.draw(mText, states);
 }
 
 void TextNode::setString(const std::string& text)
 {
-	mText.setString(text);
-	centerOrigin(mText);
-}
\ No newline at end of file
+	// Unchanged labels keep their geometry
+	if (text == mString)
+		return;
+
+	mString = text;
+	mGeometryChanged = true;
+	invalidateBoundingRect();
+}
+
+void TextNode::prebakeGlyphs(const FontHolder& fonts, const std::string& characters)
+{
+	const sf::Font& font = fonts.get(Fonts::Main);
+	FOREACH(char character, characters)
+		font.getGlyph(static_cast<unsigned char>(character), CharacterSize, false);
+}
+
+sf::FloatRect TextNode::computeBoundingRect() const
+{
+	updateGeometry();
+	return getWorldTransform().transformRect(mLocalBounds);
+}
+
+void TextNode::drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	updateGeometry();
+
+	states.texture = &mFont.getTexture(CharacterSize);
+	target.draw(mVertices, states);
+}
+
+void TextNode::batchLabelsCurrent(SpriteBatch& labels) const
+{
+	updateGeometry();
+
+	sf::VertexArray& vertices = labels.getVertices(mFont.getTexture(CharacterSize));
+	sf::Transform transform = getRenderTransform(labels.getInterpolation());
+
+	for (std::size_t i = 0; i < mVertices.getVertexCount(); ++i)
+	{
+		sf::Vertex vertex = mVertices[i];
+		vertex.position = transform.transformPoint(vertex.position);
+		vertices.append(vertex);
+	}
+}
+
+void TextNode::updateGeometry() const
+{
+	// Only ever called from drawing and culling, on the thread that owns the font
+	if (!mGeometryChanged)
+		return;
+
+	mGeometryChanged = false;
+	mVertices.clear();
+	mLocalBounds = sf::FloatRect();
+
+	if (mString.empty())
+		return;
+
+	appendTextGeometry(mVertices, mFont, mString, CharacterSize, TextColor, sf::Transform::Identity);
+
+	// Move the origin to the center of the glyphs, on whole pixels to keep them crisp
+	sf::FloatRect bounds = mVertices.getBounds();
+	sf::Vector2f center(std::floor(bounds.left + bounds.width / 2.f), std::floor(bounds.top + bounds.height / 2.f));
+
+	for (std::size_t i = 0; i < mVertices.getVertexCount(); ++i)
+		mVertices[i].position -= center;
+
+	mLocalBounds = sf::FloatRect(bounds.left - center.x, bounds.top - center.y, bounds.width, bounds.height);
+}
@@ -1,28 +1,47 @@
 #ifndef H_TEXTNODE
 #define H_TEXTNODE
 
-#include "ResourceHolder.h"
+#include "resourceHolder.h"
 #include "resourceIdentifiers.h"
 #include "SceneNode.h"
 
-#include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
 #include <SFML/Graphics/Font.hpp>
 
+#include <string>
 
+
+// Label with its origin at the center. The glyph quads are rebuilt only after the string
+// changed, the next time the label is drawn or culled, and are batched with all other labels,
+// using the font's glyph texture, in the label pass that is drawn on top of all sprites.
+// setString() doesn't touch the font, so it is safe in parallel updates.
 class TextNode : public SceneNode
 {
 	public:
-		explicit			TextNode(const FontHolder& fonts, const std::string& text);
+							TextNode(HandleTable& handles, const FontHolder& fonts, const std::string& text);
 
 		void				setString(const std::string& text);
 
+		// Loads the glyphs of the given characters into the font's texture up front
+		static void			prebakeGlyphs(const FontHolder& fonts, const std::string& characters);
+
+
+	protected:
+		virtual sf::FloatRect	computeBoundingRect() const;
+
 
 	private:
 		virtual void		drawCurrent(sf::RenderTarget& target, sf::RenderStates states) const;
+		virtual void		batchLabelsCurrent(SpriteBatch& labels) const;
+		void				updateGeometry() const;
 
 
 	private:
-		sf::Text			mText;
+		const sf::Font&			mFont;
+		std::string				mString;
+		mutable sf::VertexArray	mVertices;
+		mutable sf::FloatRect	mLocalBounds;
+		mutable bool			mGeometryChanged;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,163 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+
+
+namespace
+{
+	// Supported by every desktop GPU; asking the driver for its limit would need a GL context
+	const unsigned int MaxPageSize = 2048;
+}
+
+TextureAtlas::TextureAtlas(unsigned int pageSize)
+: mPageSize(std::min(pageSize, MaxPageSize))
+, mPending()
+, mPages()
+, mRegions()
+{
+}
+
+void TextureAtlas::load(Textures::ID id, const std::string& filename)
+{
+	sf::Image image;
+	if (!image.loadFromFile(filename))
+		throw std::runtime_error("TextureAtlas::load - Failed to load " + filename);
+
+	add(id, image);
+}
+
+void TextureAtlas::add(Textures::ID id, const sf::Image& image)
+{
+	sf::Vector2u size = image.getSize();
+	if (size.x + Padding > mPageSize || size.y + Padding > mPageSize)
+		throw std::runtime_error("TextureAtlas::add - Image doesn't fit into an atlas page");
+
+	PendingImage pending;
+	pending.id = id;
+	pending.image = image;
+	mPending.push_back(pending);
+}
+
+void TextureAtlas::pack()
+{
+	packPages(true);
+}
+
+void TextureAtlas::packWithoutTextures()
+{
+	packPages(false);
+}
+
+void TextureAtlas::packPages(bool createTextures)
+{
+	// Shelf packing: tallest images first, placed left to right in rows that are as high as their first image
+	std::sort(mPending.begin(), mPending.end(), [] (const PendingImage& lhs, const PendingImage& rhs)
+	{
+		return lhs.image.getSize().y > rhs.image.getSize().y;
+	});
+
+	std::vector<std::size_t> pageOfImage(mPending.size());
+	std::vector<sf::Vector2u> positions(mPending.size());
+	std::vector<unsigned int> pageHeights;
+
+	sf::Vector2u cursor;
+	unsigned int shelfHeight = 0;
+
+	for (std::size_t i = 0; i < mPending.size(); ++i)
+	{
+		sf::Vector2u size = mPending[i].image.getSize() + sf::Vector2u(Padding, Padding);
+
+		// Start a new shelf when the row is full, and a new page when the shelf doesn't fit
+		if (cursor.x + size.x > mPageSize)
+		{
+			cursor.x = 0;
+			cursor.y += shelfHeight;
+			shelfHeight = 0;
+		}
+
+		if (pageHeights.empty() || cursor.y + size.y > mPageSize)
+		{
+			pageHeights.push_back(0);
+			cursor = sf::Vector2u();
+			shelfHeight = 0;
+		}
+
+		pageOfImage[i] = pageHeights.size() - 1;
+		positions[i] = cursor;
+
+		cursor.x += size.x;
+		shelfHeight = std::max(shelfHeight, size.y);
+		pageHeights.back() = std::max(pageHeights.back(), cursor.y + shelfHeight);
+	}
+
+	// Pages are only as high as their content; the padding stays transparent
+	std::size_t firstPage = mPages.size();
+	for (std::size_t page = 0; page < pageHeights.size(); ++page)
+	{
+		// Without textures the page is only a number
+		std::unique_ptr<sf::Texture> texture;
+		if (createTextures)
+		{
+			texture.reset(new sf::Texture());
+
+			sf::Image pageImage;
+			pageImage.create(mPageSize, pageHeights[page], sf::Color::Transparent);
+
+			for (std::size_t i = 0; i < mPending.size(); ++i)
+			{
+				if (pageOfImage[i] == page)
+					pageImage.copy(mPending[i].image, positions[i].x, positions[i].y);
+			}
+
+			if (!texture->loadFromImage(pageImage))
+				throw std::runtime_error("TextureAtlas::pack - Failed to create atlas texture");
+		}
+
+		mPages.push_back(std::move(texture));
+	}
+
+	for (std::size_t i = 0; i < mPending.size(); ++i)
+	{
+		sf::Vector2u size = mPending[i].image.getSize();
+
+		Region region;
+		region.page = firstPage + pageOfImage[i];
+		region.texture = mPages[region.page].get();
+		region.rect = sf::IntRect(positions[i].x, positions[i].y, size.x, size.y);
+
+		auto inserted = mRegions.insert(std::make_pair(mPending[i].id, region));
+		assert(inserted.second);
+	}
+
+	// The pixels live on the GPU now, or aren't needed
+	mPending.clear();
+}
+
+const TextureAtlas::Region& TextureAtlas::get(Textures::ID id) const
+{
+	auto found = mRegions.find(id);
+	assert(found != mRegions.end());
+
+	return found->second;
+}
+
+sf::Sprite TextureAtlas::createSprite(Textures::ID id) const
+{
+	const Region& region = get(id);
+	if (!region.texture)
+	{
+		// Headless: no texture, but the rect still gives the sprite its size
+		sf::Sprite sprite;
+		sprite.setTextureRect(region.rect);
+		return sprite;
+	}
+
+	return sf::Sprite(*region.texture, region.rect);
+}
+
+std::size_t TextureAtlas::getPageCount() const
+{
+	return mPages.size();
+}
@@ -0,0 +1,69 @@
+#ifndef H_TEXTUREATLAS
+#define H_TEXTUREATLAS
+
+#include "resourceIdentifiers.h"
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+#include <map>
+#include <vector>
+#include <string>
+#include <memory>
+
+
+// Packs small images into as few textures (pages) as possible at load time, so that
+// sprites of different kinds share one texture and end up in the same draw call.
+// Images are collected with load() or add() and only uploaded to the GPU by pack().
+// packWithoutTextures() only computes the regions and creates no textures at all, so headless
+// runs need no GL context; their regions have a page and a rect, but no texture.
+// Textures that need repeat wrapping can't live in an atlas; keep them in a TextureHolder.
+class TextureAtlas : private sf::NonCopyable
+{
+	public:
+		struct Region
+		{
+			const sf::Texture*		texture;
+			std::size_t				page;
+			sf::IntRect				rect;
+		};
+
+
+	public:
+		explicit					TextureAtlas(unsigned int pageSize = 1024);
+
+		void						load(Textures::ID id, const std::string& filename);
+		void						add(Textures::ID id, const sf::Image& image);
+		void						pack();
+		void						packWithoutTextures();
+
+		const Region&				get(Textures::ID id) const;
+		sf::Sprite					createSprite(Textures::ID id) const;
+		std::size_t					getPageCount() const;
+
+
+	private:
+		void						packPages(bool createTextures);
+
+
+	private:
+		struct PendingImage
+		{
+			Textures::ID			id;
+			sf::Image				image;
+		};
+
+		static const unsigned int	Padding = 1;
+
+
+	private:
+		unsigned int								mPageSize;
+		std::vector<PendingImage>					mPending;
+		std::vector<std::unique_ptr<sf::Texture>>	mPages;
+		std::map<Textures::ID, Region>				mRegions;
+};
+
+#endif
@@ -1,6 +1,8 @@
 #include "TitleState.h"
+#include "FrameSnapshot.h"
 #include "Utility.h"
-#include "resourceHolder.h"
+#include "AssetCache.h"
+#include "World.h"
 
 #include <SFML/Graphics/RenderWindow.hpp>
 
@@ -11,22 +13,24 @@ TitleState::TitleState(StateStack& stack, Context context)
 , mShowText(true)
 , mTextEffectTime(sf::Time::Zero)
 {
-	mBackgroundSprite.setTexture(context.textures->get(Textures::TitleScreen));
+	mBackgroundSprite.setTexture(context.assets->getTextures().get(Textures::TitleScreen));
 
-	mText.setFont(context.fonts->get(Fonts::Main));
+	// Load the game's files while the player looks at the title
+	World::prefetchAssets(*context.assets, *context.jobs);
+
+	mText.setFont(context.assets->getFonts().get(Fonts::Main));
 	mText.setString("Press any key \nto start");
 	mText.setOrigin(-80, 200);
 	mText.setCharacterSize(60);
-	mText.setPosition(context.window->getView().getSize() / 2.f);
+	mText.setPosition(context.window->getDefaultView().getSize() / 2.f);
 }
 
-void TitleState::draw()
+void TitleState::draw(FrameSnapshot& frame, float)
 {
-	sf::RenderWindow& window = *getContext().window;
-	window.draw(mBackgroundSprite);
+	frame.add(mBackgroundSprite);
 
 	if (mShowText)
-		window.draw(mText);
+		frame.add(mText);
 }
 
 bool TitleState::update(sf::Time dt)
@@ -2,22 +2,12 @@
 
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/Text.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
 
-#include <random>
 #include <cmath>
-#include <ctime>
 #include <cassert>
 
-namespace
-{
-	std::default_random_engine createRandomEngine()
-	{
-		auto seed = static_cast<unsigned long>(std::time(nullptr));
-		return std::default_random_engine(seed);
-	}
-
-	auto RandomEngine = createRandomEngine();
-}
 
 std::string toString(sf::Keyboard::Key key)
 {
@@ -145,6 +135,56 @@ void centerOrigin(sf::Text& text)
 	text.setOrigin(bounds.width / 2.f, bounds.height / 2.f);
 }
 
+void appendTextGeometry(sf::VertexArray& vertices, const sf::Font& font, const sf::String& string,
+	unsigned int characterSize, const sf::Color& color, const sf::Transform& transform)
+{
+	// Same layout as sf::Text: baseline one character size below the top, whitespace only moves the pen
+	float hspace = static_cast<float>(font.getGlyph(L' ', characterSize, false).advance);
+	float vspace = static_cast<float>(font.getLineSpacing(characterSize));
+	float x = 0.f;
+	float y = static_cast<float>(characterSize);
+	sf::Uint32 previous = 0;
+
+	for (std::size_t i = 0; i < string.getSize(); ++i)
+	{
+		sf::Uint32 current = string[i];
+		x += font.getKerning(previous, current, characterSize);
+		previous = current;
+
+		if (current == ' ' || current == '\t')
+		{
+			x += (current == ' ') ? hspace : 4.f * hspace;
+			continue;
+		}
+
+		if (current == '\n')
+		{
+			y += vspace;
+			x = 0.f;
+			continue;
+		}
+
+		const sf::Glyph& glyph = font.getGlyph(current, characterSize, false);
+
+		float left = x + glyph.bounds.left;
+		float top = y + glyph.bounds.top;
+		float right = left + glyph.bounds.width;
+		float bottom = top + glyph.bounds.height;
+
+		float u1 = static_cast<float>(glyph.textureRect.left);
+		float v1 = static_cast<float>(glyph.textureRect.top);
+		float u2 = u1 + glyph.textureRect.width;
+		float v2 = v1 + glyph.textureRect.height;
+
+		vertices.append(sf::Vertex(transform.transformPoint(left, top), color, sf::Vector2f(u1, v1)));
+		vertices.append(sf::Vertex(transform.transformPoint(right, top), color, sf::Vector2f(u2, v1)));
+		vertices.append(sf::Vertex(transform.transformPoint(right, bottom), color, sf::Vector2f(u2, v2)));
+		vertices.append(sf::Vertex(transform.transformPoint(left, bottom), color, sf::Vector2f(u1, v2)));
+
+		x += glyph.advance;
+	}
+}
+
 
 float toDegree(float radian)
 {
@@ -156,12 +196,6 @@ float toRadian(float degree)
 	return 3.141592653589793238462643383f / 180.f * degree;
 }
 
-int randomInt(int exclusiveMax)
-{
-	std::uniform_int_distribution<> distr(0, exclusiveMax - 1);
-	return distr(RandomEngine);
-}
-
 float length(sf::Vector2f vector)
 {
 	return std::sqrt(vector.x * vector.x + vector.y * vector.y);
@@ -10,6 +10,11 @@ namespace sf
 {
 	class Sprite;
 	class Text;
+	class Font;
+	class String;
+	class Color;
+	class Transform;
+	class VertexArray;
 }
 
 // Since std::to_string doesn't work on MinGW we have to implement
@@ -24,13 +29,14 @@ std::string		toString(sf::Keyboard::Key key);
 void centerOrigin(sf::Sprite& sprite);
 void centerOrigin(sf::Text& text);
 
+// Append the glyph quads of a string laid out like sf::Text in regular style
+void appendTextGeometry(sf::VertexArray& vertices, const sf::Font& font, const sf::String& string,
+	unsigned int characterSize, const sf::Color& color, const sf::Transform& transform);
+
 // Degree/radian conversion
 float			toDegree(float radian);
 float			toRadian(float degree);
 
-// Random number generation
-int				randomInt(int exclusiveMax);
-
 // Vector operations
 float			length(sf::Vector2f vector);
 sf::Vector2f	unitVector(sf::Vector2f vector);
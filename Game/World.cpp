@@ -1,91 +1,228 @@
 #include "World.h"
-#include "Projectile.h"
 #include "Pickup.h"
 #include "Foreach.h"
 #include "TextNode.h"
+#include "Utility.h"
+#include "Profiler.h"
+#include "FrameSnapshot.h"
 
 #include <SFML/Graphics/RenderWindow.hpp>
 
 #include <algorithm>
 #include <cmath>
-#include <limits>
+#include <cassert>
 
 
-World::World(sf::RenderWindow& window, FontHolder& fonts)
+namespace
+{
+	struct AssetFile
+	{
+		Textures::ID	id;
+		const char*		filename;
+	};
+
+	// The background is tiled with repeat wrapping, so it keeps a texture of its own
+	const AssetFile BackgroundFile = { Textures::Water, "water.png" };
+
+	// Animals, projectiles and pickups share one texture, packed from these images
+	const AssetFile SpriteFiles[] =
+	{
+		{ Textures::Duck,			"Duck.png" },
+		{ Textures::Frog,			"frog.png" },
+		{ Textures::LaserBeam,		"laser.png" },
+		{ Textures::Quack,			"quack.png" },
+		{ Textures::HealthRefill,	"HealthRefill.png" },
+		{ Textures::QuackRefill,	"QuackRefill.png" },
+		{ Textures::FireSpread,		"FireSpread.png" },
+		{ Textures::FireRate,		"FireRate.png" },
+	};
+
+	const std::size_t SpriteFileCount = sizeof(SpriteFiles) / sizeof(SpriteFiles[0]);
+}
+
+World::World(sf::Vector2f viewSize, sf::RenderWindow* window, AssetCache& assets, sf::Uint64 seed, JobSystem* jobs)
 : mWindow(window)
-, mFonts(fonts)
-, mWorldView(window.getDefaultView())
-, mTextures() 
-, mSceneGraph()
+, mWorldView(sf::FloatRect(0.f, 0.f, viewSize.x, viewSize.y))
+, mPreviousViewCenter()
+, mAssets(assets)
+, mBackgroundTexture()
+, mSpriteAtlasReference()
+, mSpriteAtlas(nullptr)
+, mFonts(window ? &assets.getFonts() : nullptr)
+, mRandom(seed)
+, mJobs(jobs)
+, mParallelCollisions(true)
+, mCollisionMatrix()
+, mCollisionGrid(100.f, mCollisionMatrix)
+, mCategoryRegistry()
+, mHandles()
+, mSceneGraph(mHandles)
 , mSceneLayers()
+, mCommandQueue()
+, mJobCommands()
+, mCullStats()
+, mCollisionPairs()
 , mWorldBounds(0.f, 0.f, mWorldView.getSize().x, 3000.f)
 , mSpawnPosition(mWorldView.getSize().x / 2.f, mWorldBounds.height - mWorldView.getSize().y / 2.f)
 , mScrollSpeed(-30.f)
-, mPlayerAnimal(nullptr)
+, mPlayerAnimal()
+, mProjectiles(nullptr)
 , mEnemySpawnPoints()
-, mActiveEnemies()
+, mNearestEnemies()
 {
 	loadTextures();
+	buildCollisionMatrix();
+
+	// Everything the entity labels can show, so the glyph texture doesn't change mid-game
+	if (mFonts)
+		TextNode::prebakeGlyphs(*mFonts, "0123456789 HPQUACKS:");
 	buildScene();
 
 	// Prepare the view
 	mWorldView.setCenter(mSpawnPosition);
+	mPreviousViewCenter = mSpawnPosition;
 }
 
 void World::update(sf::Time dt)
 {
-	// Scroll the world, reset player velocity
-	//if player isn't moved, automatically moves down with background
-	mWorldView.move(0.f, mScrollSpeed * dt.asSeconds());	
-	mPlayerAnimal->setVelocity(0.f, 30.f);
+	PROFILE_SCOPE("World::update");
 
-	// Setup commands to destroy entities, and guide Quack
-	destroyEntitiesOutsideView();
-	guideQuack();
+	{
+		PROFILE_SCOPE("commands");
+
+		// Scroll the world, reset player velocity
+		//if player isn't moved, automatically moves down with background
+		mPreviousViewCenter = mWorldView.getCenter();
+		mWorldView.move(0.f, mScrollSpeed * dt.asSeconds());	
+		mPlayerAnimal->setVelocity(0.f, 30.f);
+
+		// Setup commands to destroy entities, and guide Quack
+		destroyEntitiesOutsideView();
+		guideQuack();
+		PROFILE_COUNTER("command queue", mCommandQueue.getSize());
+
+		// Forward commands to the registered nodes of matching category, adapt velocity (scrolling, diagonal correction)
+		while (!mCommandQueue.isEmpty())
+			mCategoryRegistry.onCommand(mCommandQueue.pop(), dt);
+		adaptPlayerVelocity();
+	}
 
-	// Forward commands to scene graph, adapt velocity (scrolling, diagonal correction)
-	while (!mCommandQueue.isEmpty())
-		mSceneGraph.onCommand(mCommandQueue.pop(), dt);
-	adaptPlayerVelocity();
+	{
+		PROFILE_SCOPE("collision");
 
-	
-	// Collision detection and response (may destroy entities)
-	handleCollisions();
+		// Collision detection and response (may destroy entities)
+		handleCollisions();
+	}
+
+	{
+		PROFILE_SCOPE("wreck removal");
 
 		// Remove all destroyed entities, create new ones
-	mSceneGraph.removeWrecks();
-	spawnEnemies();
+		mSceneGraph.removeWrecks();
+	}
 
-	// Regular update step, adapt position (correct if outside view)
-	mSceneGraph.update(dt, mCommandQueue);
-	adaptPlayerPosition();
+	{
+		PROFILE_SCOPE("spawning");
+		spawnEnemies();
+	}
+
+	{
+		PROFILE_SCOPE("scene update");
+
+		// Regular update step, adapt position (correct if outside view)
+		if (mJobs)
+			mSceneGraph.updateParallel(dt, mCommandQueue, *mJobs, mJobCommands);
+		else
+			mSceneGraph.update(dt, mCommandQueue);
+
+		adaptPlayerPosition();
+
+		// Move the entities that changed cells, so collisions and queries see this frame's positions
+		mCollisionGrid.update();
+	}
+
+	PROFILE_COUNTER("entities", mCategoryRegistry.getCount(Category::Collidable) + mProjectiles->getProjectileCount());
+	PROFILE_COUNTER("pickup pool blocks", Pickup::getPoolStats().capacity);
 }
 
-void World::draw()
+void World::draw(FrameSnapshot& frame, float alpha)
 {
-	mWindow.setView(mWorldView);
-	mWindow.draw(mSceneGraph);
+	PROFILE_SCOPE("World::draw");
+	assert(mWindow);
+
+	// The view scrolls along with the entities
+	sf::View view(mWorldView);
+	view.setCenter(mPreviousViewCenter + (mWorldView.getCenter() - mPreviousViewCenter) * alpha);
+	sf::FloatRect viewBounds(view.getCenter() - view.getSize() / 2.f, view.getSize());
+
+	frame.setView(view);
+	mCullStats.drawn = 0;
+	mCullStats.culled = 0;
+
+	// Layers from bottom to top, every layer draws its sprites with one draw call per texture
+	std::size_t drawCalls = 0;
+	FOREACH(SceneNode* layer, mSceneLayers)
+	{
+		SpriteBatch& batch = frame.addBatch();
+		batch.setViewBounds(viewBounds);
+		batch.setInterpolation(alpha);
+		layer->fillBatch(batch);
+
+		drawCalls += batch.getDrawCallCount();
+		mCullStats.drawn += batch.getCullStats().drawn;
+		mCullStats.culled += batch.getCullStats().culled;
+	}
+
+	// Labels in their own pass after all sprites, so they are never covered by one
+	SpriteBatch& labels = frame.addBatch();
+	labels.setViewBounds(viewBounds);
+	labels.setInterpolation(alpha);
+	FOREACH(SceneNode* layer, mSceneLayers)
+		layer->fillLabelBatch(labels);
+
+	drawCalls += labels.getDrawCallCount();
+
+	PROFILE_COUNTER("draw calls", drawCalls);
+	PROFILE_COUNTER("culled", mCullStats.culled);
 }
 
 void World::loadTextures()
 {
-	mTextures.load(Textures::Duck, "Duck.png");
-	mTextures.load(Textures::Water, "water.png");
-	mTextures.load(Textures::Frog, "frog.png");
-
-	mTextures.load(Textures::LaserBeam, "laser.png");
-	mTextures.load(Textures::Quack, "quack.png");
-
-	mTextures.load(Textures::HealthRefill, "HealthRefill.png");
-	mTextures.load(Textures::QuackRefill, "QuackRefill.png");
-	mTextures.load(Textures::FireSpread, "FireSpread.png");
-	mTextures.load(Textures::FireRate, "FireRate.png"); 
-	
+	// Headless runs don't draw the background
+	if (mWindow)
+		mBackgroundTexture.acquire(mAssets.getTextures(), BackgroundFile.id, BackgroundFile.filename);
+
+	// Packing uploads to the GPU, so the atlas is only built when the cache doesn't have it yet
+	AtlasHolder& atlases = mAssets.getAtlases();
+	if (!atlases.isLoaded(Atlases::Sprites))
+		buildSpriteAtlas();
+
+	mSpriteAtlas = &mSpriteAtlasReference.acquire(atlases, Atlases::Sprites);
+}
+
+void World::buildSpriteAtlas()
+{
+	ImageHolder& images = mAssets.getImages();
+	std::unique_ptr<TextureAtlas> atlas(new TextureAtlas());
+
+	// Released once packed: the atlas copies the pixels, so the images are only needed to rebuild it
+	std::array<ImageReference, SpriteFileCount> imageReferences;
+	for (std::size_t i = 0; i < SpriteFileCount; ++i)
+		atlas->add(SpriteFiles[i].id, imageReferences[i].acquire(images, SpriteFiles[i].id, SpriteFiles[i].filename));
+
+	// Headless runs only need the sprite sizes
+	if (mWindow)
+		atlas->pack();
+	else
+		atlas->packWithoutTextures();
+
+	mAssets.getAtlases().insert(Atlases::Sprites, "sprites", std::move(atlas));
 }
 
 bool World::hasAlivePlayer() const
 {
-	return !mPlayerAnimal->isMarkedForRemoval();
+	Animal* player = mPlayerAnimal.get();
+	return player && !player->isMarkedForRemoval();
 }
 
 bool World::hasPlayerReachedEnd() const
@@ -93,96 +230,104 @@ bool World::hasPlayerReachedEnd() const
 	return !mWorldBounds.contains(mPlayerAnimal->getPosition());
 }
 
+void World::findNearest(sf::Vector2f position, unsigned int categories, std::size_t count, std::vector<SceneNode*>& result) const
+{
+	mCollisionGrid.findNearest(position, categories, count, result);
+}
 
-bool matchesCategories(SceneNode::Pair& colliders, Category::Type type1, Category::Type type2)
+void World::findWithinRadius(sf::Vector2f position, float radius, unsigned int categories, std::vector<SceneNode*>& result) const
 {
-	unsigned int category1 = colliders.first->getCategory();
-	unsigned int category2 = colliders.second->getCategory();
+	mCollisionGrid.findWithinRadius(position, radius, categories, result);
+}
 
-	// Make sure first pair entry has category type1 and second has type2
-	if (type1 & category1 && type2 & category2)
-	{
-		return true;
-	}
-	else if (type1 & category2 && type2 & category1)
-	{
-		std::swap(colliders.first, colliders.second);
-		return true;
-	}
-	else
-	{
-		return false;
-	}
+SceneNode* World::findFirstAlongRay(sf::Vector2f origin, sf::Vector2f direction, float maxDistance, unsigned int categories) const
+{
+	return mCollisionGrid.findFirstAlongRay(origin, direction, maxDistance, categories);
 }
 
-void World::handleCollisions()
+const SpriteBatch::CullStats& World::getCullStats() const
 {
-	std::set<SceneNode::Pair> collisionPairs;
-	mSceneGraph.checkSceneCollision(mSceneGraph, collisionPairs);
+	return mCullStats;
+}
 
-	FOREACH(SceneNode::Pair pair, collisionPairs)
-	{
-		if (matchesCategories(pair, Category::PlayerAnimal, Category::EnemyAnimal))
-		{
-			auto& player = static_cast<Animal&>(*pair.first);
-			auto& enemy = static_cast<Animal&>(*pair.second);
 
-			// Collision: Player damage  = 1 
-			//enemy doesn't die from collision with player
-			player.damage(1);
-		}
+void World::handleCollisions()
+{
+	// Broad phase in the grid, narrow phase for the pairs sharing a cell
+	if (mJobs && mParallelCollisions)
+		mCollisionGrid.findPairs(mCollisionPairs, *mJobs);
+	else
+		mCollisionGrid.findPairs(mCollisionPairs);
 
-		else if (matchesCategories(pair, Category::PlayerAnimal, Category::Pickup))
-		{
-			auto& player = static_cast<Animal&>(*pair.first);
-			auto& pickup = static_cast<Pickup&>(*pair.second);
+	// Every reported pair has a registered handler; they are applied one by one, in canonical order
+	FOREACH(SceneNode::Pair pair, mCollisionPairs)
+		mCollisionMatrix.dispatch(*pair.first, *pair.second);
 
-			// Apply pickup effect to player, destroy projectile
-			pickup.apply(player);
-			pickup.destroy();
-		}
+	// Projectiles are tested against the animals in the grid in bulk
+	mProjectiles->checkCollisions(mCollisionGrid);
+}
 
-		else if (matchesCategories(pair, Category::EnemyAnimal, Category::AlliedProjectile)
-			  || matchesCategories(pair, Category::PlayerAnimal, Category::EnemyProjectile))
-		{
-			auto& animal = static_cast<Animal&>(*pair.first);
-			auto& projectile = static_cast<Projectile&>(*pair.second);
+void World::buildCollisionMatrix()
+{
+	// Collision: Player damage = 1, enemy doesn't die from collision with player
+	mCollisionMatrix.addHandler(Category::PlayerAnimal, Category::EnemyAnimal, derivedCollision<Animal, Animal>([] (Animal& player, Animal&)
+	{
+		player.damage(1);
+	}));
 
-			// Apply projectile damage to Animal, destroy projectile
-			animal.damage(projectile.getDamage());
-			projectile.destroy();
-		}
-	}
+	// Apply pickup effect to player, destroy pickup
+	mCollisionMatrix.addHandler(Category::PlayerAnimal, Category::Pickup, derivedCollision<Animal, Pickup>([] (Animal& player, Pickup& pickup)
+	{
+		pickup.apply(player);
+		pickup.destroy();
+	}));
+
+	// Projectile hits are resolved by ProjectileSystem::checkCollisions
 }
 
 void World::buildScene()
 {
+	// Every node attached below the root is registered by category, entities also in the grid covering the world
+	mCollisionGrid.reset(mWorldBounds);
+	mCategoryRegistry.setCollisionGrid(&mCollisionGrid);
+	mSceneGraph.setCategoryRegistry(&mCategoryRegistry);
+
 	// Initialize the different layers
 	for (std::size_t i = 0; i < LayerCount; ++i)
 	{
-		SceneNode::Ptr layer(new SceneNode());
+		Category::Type category = (i == Air) ? Category::SceneAirLayer : Category::None;
+
+		SceneNode::Ptr layer(new SceneNode(mHandles, category));
 		mSceneLayers[i] = layer.get();
 
 		mSceneGraph.attachChild(std::move(layer));
 	}
 
 	// Prepare the tiled background
-	sf::Texture& texture = mTextures.get(Textures::Water);
-	sf::IntRect textureRect(mWorldBounds);
-	texture.setRepeated(true);
-
-	// Add the background sprite to the scene
-	std::unique_ptr<SpriteNode> backgroundSprite(new SpriteNode(texture, textureRect));
-	backgroundSprite->setPosition(mWorldBounds.left, mWorldBounds.top);
-	mSceneLayers[Background]->attachChild(std::move(backgroundSprite));
+	if (mWindow)
+	{
+		sf::Texture& texture = mAssets.getTextures().get(BackgroundFile.id);
+		sf::IntRect textureRect(mWorldBounds);
+		texture.setRepeated(true);
+
+		// Add the background sprite to the scene
+		std::unique_ptr<SpriteNode> backgroundSprite(new SpriteNode(mHandles, texture, textureRect));
+		backgroundSprite->setPosition(mWorldBounds.left, mWorldBounds.top);
+		mSceneLayers[Background]->attachChild(std::move(backgroundSprite));
+	}
 
 	// Add player's duck
-	std::unique_ptr<Animal> leader(new Animal(Animal::Duck, mTextures, mFonts));
-	mPlayerAnimal = leader.get();
-	mPlayerAnimal->setPosition(mSpawnPosition);
-	mPlayerAnimal->setVelocity(30.f, mScrollSpeed);
+	std::unique_ptr<Animal> leader(new Animal(mHandles, Animal::Duck, *mSpriteAtlas, mFonts, mRandom));
+	mPlayerAnimal = Handle<Animal>(*leader);
+	leader->setPosition(mSpawnPosition);
+	leader->setVelocity(30.f, mScrollSpeed);
 	mSceneLayers[Air]->attachChild(std::move(leader));
 
+	// Add the system that owns all lasers and Quacks
+	std::unique_ptr<ProjectileSystem> projectiles(new ProjectileSystem(mHandles, *mSpriteAtlas, mJobs));
+	mProjectiles = projectiles.get();
+	mSceneLayers[Air]->attachChild(std::move(projectiles));
+
 	//add enemys
 	addEnemies();
 
@@ -213,11 +358,59 @@ void World::adaptPlayerVelocity()
 	// Add scrolling velocity
 	mPlayerAnimal->accelerate(0.f, mScrollSpeed);
 }
+void World::prefetchAssets(AssetCache& assets, JobSystem& jobs)
+{
+	TextureHolder& textures = assets.getTextures();
+	ImageHolder& images = assets.getImages();
+
+	// Every level needs these; keep them when a world releases them, for the next one
+	textures.setRetained(BackgroundFile.id, true);
+	assets.getAtlases().setRetained(Atlases::Sprites, true);
+
+	if (!textures.isLoaded(BackgroundFile.id) && !textures.isLoading(BackgroundFile.id))
+		textures.loadAsync(BackgroundFile.id, BackgroundFile.filename, jobs);
+
+	// Once the atlas is built, its images aren't needed any more
+	if (assets.getAtlases().isLoaded(Atlases::Sprites))
+		return;
+
+	for (std::size_t i = 0; i < SpriteFileCount; ++i)
+	{
+		if (!images.isLoaded(SpriteFiles[i].id) && !images.isLoading(SpriteFiles[i].id))
+			images.loadAsync(SpriteFiles[i].id, SpriteFiles[i].filename, jobs);
+	}
+}
+
+float World::getAssetProgress(AssetCache& assets)
+{
+	std::size_t loaded = assets.getTextures().isLoaded(BackgroundFile.id) ? 1 : 0;
+
+	if (assets.getAtlases().isLoaded(Atlases::Sprites))
+	{
+		loaded += SpriteFileCount;
+	}
+	else
+	{
+		for (std::size_t i = 0; i < SpriteFileCount; ++i)
+		{
+			if (assets.getImages().isLoaded(SpriteFiles[i].id))
+				++loaded;
+		}
+	}
+
+	return static_cast<float>(loaded) / (SpriteFileCount + 1);
+}
+
 CommandQueue& World::getCommandQueue()
 {
 	return mCommandQueue;
 }
 
+Random& World::getRandom()
+{
+	return mRandom;
+}
+
 void World::addEnemies()
 {
 	// Add enemies to the spawn point container
@@ -229,19 +422,31 @@ void World::addEnemies()
 	addEnemy(Animal::Frog,  -100.f, 800.f);
 	addEnemy(Animal::Frog, +70.f, 1300.f);
 	addEnemy(Animal::Frog, +270.f, 2100.f);
-	
+}
 
-	// Sort all enemies according to their y value, such that lower enemies are checked first for spawning
-	std::sort(mEnemySpawnPoints.begin(), mEnemySpawnPoints.end(), [] (SpawnPoint lhs, SpawnPoint rhs)
+void World::addEnemy(Animal::Type type, float relX, float relY)
+{
+	// Keep the spawn points sorted by y, lower enemies are checked first for spawning
+	SpawnPoint spawn(type, mSpawnPosition.x + relX, mSpawnPosition.y - relY);
+	auto position = std::upper_bound(mEnemySpawnPoints.begin(), mEnemySpawnPoints.end(), spawn, [] (SpawnPoint lhs, SpawnPoint rhs)
 	{
 		return lhs.y < rhs.y;
 	});
+
+	mEnemySpawnPoints.insert(position, spawn);
 }
 
-void World::addEnemy(Animal::Type type, float relX, float relY)
+void World::addPickup(Pickup::Type type, float relX, float relY)
 {
-	SpawnPoint spawn(type, mSpawnPosition.x + relX, mSpawnPosition.y - relY);
-	mEnemySpawnPoints.push_back(spawn);
+	std::unique_ptr<Pickup> pickup(new Pickup(mHandles, type, *mSpriteAtlas));
+	pickup->setPosition(mSpawnPosition.x + relX, mSpawnPosition.y - relY);
+	pickup->setVelocity(0.f, 1.f);
+	mSceneLayers[Air]->attachChild(std::move(pickup));
+}
+
+void World::setParallelCollisions(bool enabled)
+{
+	mParallelCollisions = enabled;
 }
 
 void World::spawnEnemies()
@@ -252,7 +457,7 @@ void World::spawnEnemies()
 	{
 		SpawnPoint spawn = mEnemySpawnPoints.back();
 		
-		std::unique_ptr<Animal> enemy(new Animal(spawn.type, mTextures, mFonts));
+		std::unique_ptr<Animal> enemy(new Animal(mHandles, spawn.type, *mSpriteAtlas, mFonts, mRandom));
 		enemy->setPosition(spawn.x, spawn.y);
 		enemy->setRotation(180.f);
 
@@ -266,59 +471,45 @@ void World::spawnEnemies()
 void World::destroyEntitiesOutsideView()
 {
 	Command command;
-	command.category = Category::Projectile | Category::EnemyAnimal;
+	command.category = Category::EnemyAnimal;
 	command.action = derivedAction<Entity>([this] (Entity& e, sf::Time)
 	{
 		if (!getBattlefieldBounds().intersects(e.getBoundingRect()))
 			e.destroy();
 	});
 
+	Command projectileCommand;
+	projectileCommand.category = Category::ProjectileSystem;
+	projectileCommand.action = derivedAction<ProjectileSystem>([this] (ProjectileSystem& projectiles, sf::Time)
+	{
+		projectiles.destroyOutside(getBattlefieldBounds());
+	});
+
 	mCommandQueue.push(command);
+	mCommandQueue.push(projectileCommand);
 }
 
 void World::guideQuack()
 {
-	// Setup command that stores all enemies in mActiveEnemies
-	Command enemyCollector;
-	enemyCollector.category = Category::EnemyAnimal;
-	enemyCollector.action = derivedAction<Animal>([this] (Animal& enemy, sf::Time)
-	{
-		if (!enemy.isDestroyed())
-			mActiveEnemies.push_back(&enemy);
-	});
-
-	// Setup command that guides all Quacks to the enemy which is currently closest to the player
+	// Setup command that guides all Quacks to the enemy which is currently closest to them
 	Command QuackGuider;
-	QuackGuider.category = Category::AlliedProjectile;
-	QuackGuider.action = derivedAction<Projectile>([this] (Projectile& Quack, sf::Time)
+	QuackGuider.category = Category::ProjectileSystem;
+	QuackGuider.action = derivedAction<ProjectileSystem>([this] (ProjectileSystem& projectiles, sf::Time)
 	{
-		// Ignore unguided 
-		if (!Quack.isGuided())
-			return;
-
-		float minDistance = std::numeric_limits<float>::max();
-		Animal* closestEnemy = nullptr;
-
-		// Find closest enemy
-		FOREACH(Animal* enemy, mActiveEnemies)
+		for (std::size_t i = 0; i < projectiles.getProjectileCount(); ++i)
 		{
-			float enemyDistance = distance(Quack, *enemy);
+			// Ignore unguided 
+			if (!projectiles.isGuided(i))
+				continue;
 
-			if (enemyDistance < minDistance)
-			{
-				closestEnemy = enemy;
-				minDistance = enemyDistance;
-			}
-		}
+			findNearest(projectiles.getPosition(i), Category::EnemyAnimal, 1, mNearestEnemies);
 
-		if (closestEnemy)
-			Quack.guideTowards(closestEnemy->getWorldPosition());
+			if (!mNearestEnemies.empty())
+				projectiles.guideTowards(i, mNearestEnemies.front()->getWorldPosition());
+		}
 	});
 
-	// Push commands, reset active enemies
-	mCommandQueue.push(enemyCollector);
 	mCommandQueue.push(QuackGuider);
-	mActiveEnemies.clear();
 }
 
 sf::FloatRect World::getViewBounds() const
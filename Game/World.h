@@ -1,13 +1,22 @@
 #ifndef H_WORLD
 #define H_WORLD
 
-#include "ResourceHolder.h"
-#include "ResourceIdentifiers.h"
+#include "AssetCache.h"
+#include "TextureAtlas.h"
+#include "resourceIdentifiers.h"
 #include "SceneNode.h"
 #include "SpriteNode.h"
 #include "Animal.h"
+#include "Pickup.h"
+#include "Handle.h"
+#include "ProjectileSystem.h"
 #include "CommandQueue.h"
+#include "CategoryRegistry.h"
 #include "Command.h"
+#include "CollisionMatrix.h"
+#include "CollisionGrid.h"
+#include "SpriteBatch.h"
+#include "Random.h"
 
 #include <SFML/System/NonCopyable.hpp>
 #include <SFML/Graphics/View.hpp>
@@ -22,27 +31,60 @@ namespace sf
 	class RenderWindow;
 }
 
+class FrameSnapshot;
+class JobSystem;
+
 class World : private sf::NonCopyable
 {
 	public:
-		explicit							World(sf::RenderWindow& window, FontHolder& fonts);
+		// Without window the world runs headless: no textures are uploaded to the GPU,
+		// entities get no labels and draw() must not be called. All randomness comes from the
+		// seed, so equal seeds and inputs reproduce a run exactly. With a job system, the entities are
+		// updated in parallel; the outcome is the same as without. The world's assets come from the
+		// cache and are loaded by the constructor if they aren't there; a cache serves either windowed
+		// or headless worlds. Labels use the cache's main font.
+											World(sf::Vector2f viewSize, sf::RenderWindow* window, AssetCache& assets, sf::Uint64 seed, JobSystem* jobs);
 		void								update(sf::Time dt);
-		void								draw();
+
+		// Starts loading the world's files in the background, so constructing a world doesn't stall.
+		// Also retains the assets every level shares, so restarts find them in the cache.
+		static void							prefetchAssets(AssetCache& assets, JobSystem& jobs);
+		static float						getAssetProgress(AssetCache& assets);
+
+		// Records the state at alpha between the previous and the last update, for smooth motion at any frame rate
+		void								draw(FrameSnapshot& frame, float alpha);
 
 		CommandQueue&						getCommandQueue();
+		Random&								getRandom();
 
 		bool 								hasAlivePlayer() const;
 		bool 								hasPlayerReachedEnd() const;
 
+		// Spatial queries over all entities of the given categories that collide with anything, served by the collision grid
+		void								findNearest(sf::Vector2f position, unsigned int categories, std::size_t count, std::vector<SceneNode*>& result) const;
+		void								findWithinRadius(sf::Vector2f position, float radius, unsigned int categories, std::vector<SceneNode*>& result) const;
+		SceneNode*							findFirstAlongRay(sf::Vector2f origin, sf::Vector2f direction, float maxDistance, unsigned int categories) const;
+
+		// Nodes and projectiles drawn and culled in the last frame
+		const SpriteBatch::CullStats&		getCullStats() const;
+
+		// Scenario setup, relative to the player's spawn position; enemies appear once the view reaches them, pickups immediately
+		void								addEnemy(Animal::Type type, float relX, float relY);
+		void								addPickup(Pickup::Type type, float relX, float relY);
+
+		// With a job system, the narrow phase runs on all threads unless switched off; the pairs are handled in the same order either way
+		void								setParallelCollisions(bool enabled);
+
 	private:
 		void								loadTextures();
+		void								buildSpriteAtlas();
 		void								adaptPlayerPosition();
 		void								adaptPlayerVelocity();
 		void								handleCollisions();
+		void								buildCollisionMatrix();
 
 		void								buildScene();
 		void								addEnemies();
-		void								addEnemy(Animal::Type type, float relX, float relY);
 		void								spawnEnemies();
 		void								destroyEntitiesOutsideView();
 		void								guideQuack();
@@ -75,22 +117,37 @@ class World : private sf::NonCopyable
 
 
 	private:
-		sf::RenderWindow&					mWindow;
+		sf::RenderWindow*					mWindow;
 		sf::View							mWorldView;
-		TextureHolder						mTextures;
-		FontHolder&							mFonts;
-
+		sf::Vector2f						mPreviousViewCenter;
+		AssetCache&							mAssets;
+		TextureReference					mBackgroundTexture;
+		AtlasReference						mSpriteAtlasReference;
+		const TextureAtlas*					mSpriteAtlas;
+		FontHolder*							mFonts;
+		Random								mRandom;
+		JobSystem*							mJobs;
+		bool								mParallelCollisions;
+
+		CollisionMatrix						mCollisionMatrix;
+		CollisionGrid						mCollisionGrid;
+		CategoryRegistry					mCategoryRegistry;
+		HandleTable							mHandles;
 		SceneNode							mSceneGraph;
 		std::array<SceneNode*, LayerCount>	mSceneLayers;
 		CommandQueue						mCommandQueue;
+		std::vector<CommandQueue>			mJobCommands;
+		SpriteBatch::CullStats				mCullStats;
+		std::vector<SceneNode::Pair>		mCollisionPairs;
 
 		sf::FloatRect						mWorldBounds;
 		sf::Vector2f						mSpawnPosition;
 		float								mScrollSpeed;
-		Animal*								mPlayerAnimal;
+		Handle<Animal>						mPlayerAnimal;
+		ProjectileSystem*					mProjectiles;
 
 		std::vector<SpawnPoint>				mEnemySpawnPoints;
-		std::vector<Animal*>				mActiveEnemies;
+		std::vector<SceneNode*>				mNearestEnemies;
 };
 
 #endif 
\ No newline at end of file
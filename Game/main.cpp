@@ -6,13 +6,29 @@
 
 #include <stdexcept>
 #include <iostream>
+#include <string>
 
 
-int main()
+// Usage: Game [--record file | --replay file] [--render-thread]
+int main(int argc, char* argv[])
 {
 	try
 	{
 		Application app;
+
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string option = argv[i];
+			bool hasValue = (i + 1 < argc);
+
+			if (option == "--record" && hasValue)
+				app.recordInput(argv[++i]);
+			else if (option == "--replay" && hasValue && !app.replayInput(argv[++i]))
+				throw std::runtime_error("Failed to load replay " + std::string(argv[i]));
+			else if (option == "--render-thread")
+				app.enableRenderThread();
+		}
+
 		app.run();
 	}
 	catch (std::exception& e)
@@ -1,13 +1,49 @@
 #ifndef H_RESOURCEHOLDER
 #define H_RESOURCEHOLDER
 
+#include "JobSystem.h"
+
+#include <SFML/System/NonCopyable.hpp>
+#include <SFML/System/Sleep.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
 #include <map>
+#include <set>
+#include <vector>
 #include <string>
 #include <memory>
+#include <functional>
 #include <stdexcept>
 #include <cassert>
 
 
+// How a resource is loaded in the background: decode() runs on a worker thread, finish() on the
+// thread that calls updateLoading(). By default, the worker loads the whole resource.
+template <typename Resource>
+struct AsyncLoading
+{
+	typedef Resource Decoded;
+
+	static bool							decode(Decoded& decoded, const std::string& filename);
+	static std::unique_ptr<Resource>	finish(std::unique_ptr<Decoded> decoded);
+};
+
+// Textures are decoded to images on the worker; only the upload needs the thread with the GL context
+template <>
+struct AsyncLoading<sf::Texture>
+{
+	typedef sf::Image Decoded;
+
+	static bool							decode(Decoded& decoded, const std::string& filename);
+	static std::unique_ptr<sf::Texture>	finish(std::unique_ptr<Decoded> decoded);
+};
+
+
+// Resources are keyed by ID and remember the file they came from. Users that share resources
+// acquire() and release() them: a resource is loaded by its first user and destroyed with the
+// release of the last one, unless it is retained. Resources that were only loaded stay until
+// the holder goes.
 template <typename Resource, typename Identifier>
 class ResourceHolder
 {
@@ -17,19 +53,110 @@ class ResourceHolder
 		template <typename Parameter>
 		void						load(Identifier id, const std::string& filename, const Parameter& secondParam);
 
+		// Loads in the background; the resource can be got once updateLoading() or finishLoading() added it
+		void						loadAsync(Identifier id, const std::string& filename, JobSystem& jobs);
+		void						updateLoading();
+		void						finishLoading();
+
+		// Acquiring waits for a load in the background; the ID must always come with the same file
+		Resource&					acquire(Identifier id, const std::string& filename);
+		Resource&					acquire(Identifier id);
+		void						release(Identifier id);
+		void						setRetained(Identifier id, bool retained);
+
+		// For resources that are built rather than loaded; the key stands in for the file name
+		void						insert(Identifier id, const std::string& key, std::unique_ptr<Resource> resource);
+
+		bool						isLoaded(Identifier id) const;
+		bool						isLoading(Identifier id) const;
+
 		Resource&					get(Identifier id);
 		const Resource&				get(Identifier id) const;
 
 
 	private:
-		void						insertResource(Identifier id, std::unique_ptr<Resource> resource);
+		typedef typename AsyncLoading<Resource>::Decoded Decoded;
+
+		struct Entry
+		{
+			std::unique_ptr<Resource>	resource;
+			std::string					filename;
+			std::size_t					references;
+		};
+
+		struct PendingLoad
+		{
+			Identifier					id;
+			std::string					filename;
+			std::unique_ptr<Decoded>	decoded;
+			JobSystem::TaskHandle		task;
+		};
+
+
+	private:
+		void						insertResource(Identifier id, const std::string& filename, std::unique_ptr<Resource> resource);
+		void						finishLoad(PendingLoad& load);
+		void						waitForLoad(Identifier id);
+		static void					decode(std::shared_ptr<PendingLoad> load);
+
+
+	private:
+		std::map<Identifier, std::unique_ptr<Entry>>	mResourceMap;
+		std::vector<std::shared_ptr<PendingLoad>>		mPendingLoads;
+		std::set<Identifier>							mRetained;
+};
+
+
+// One acquired reference to a resource of a holder, released with the reference or by reset()
+template <typename Resource, typename Identifier>
+class ResourceReference : private sf::NonCopyable
+{
+	public:
+		typedef ResourceHolder<Resource, Identifier> Holder;
+
+
+	public:
+									ResourceReference();
+									~ResourceReference();
+
+		Resource&					acquire(Holder& holder, Identifier id, const std::string& filename);
+		Resource&					acquire(Holder& holder, Identifier id);
+		void						reset();
 
 
 	private:
-		std::map<Identifier, std::unique_ptr<Resource>>	mResourceMap;
+		Holder*						mHolder;
+		Identifier					mId;
 };
 
 
+template <typename Resource>
+bool AsyncLoading<Resource>::decode(Decoded& decoded, const std::string& filename)
+{
+	return decoded.loadFromFile(filename);
+}
+
+template <typename Resource>
+std::unique_ptr<Resource> AsyncLoading<Resource>::finish(std::unique_ptr<Decoded> decoded)
+{
+	return decoded;
+}
+
+inline bool AsyncLoading<sf::Texture>::decode(Decoded& decoded, const std::string& filename)
+{
+	return decoded.loadFromFile(filename);
+}
+
+inline std::unique_ptr<sf::Texture> AsyncLoading<sf::Texture>::finish(std::unique_ptr<Decoded> decoded)
+{
+	std::unique_ptr<sf::Texture> texture(new sf::Texture());
+	if (!texture->loadFromImage(*decoded))
+		texture.reset();
+
+	return texture;
+}
+
+
 
 template <typename Resource, typename Identifier>
 void ResourceHolder<Resource, Identifier>::load(Identifier id, const std::string& filename)
@@ -40,7 +167,7 @@ void ResourceHolder<Resource, Identifier>::load(Identifier id, const std::string
 		throw std::runtime_error("ResourceHolder::load - Failed to load " + filename);
 
 	// If loading successful, insert resource to map
-	insertResource(id, std::move(resource));
+	insertResource(id, filename, std::move(resource));
 }
 
 template <typename Resource, typename Identifier>
@@ -53,7 +180,147 @@ void ResourceHolder<Resource, Identifier>::load(Identifier id, const std::string
 		throw std::runtime_error("ResourceHolder::load - Failed to load " + filename);
 
 	// If loading successful, insert resource to map
-	insertResource(id, std::move(resource));
+	insertResource(id, filename, std::move(resource));
+}
+
+template <typename Resource, typename Identifier>
+void ResourceHolder<Resource, Identifier>::loadAsync(Identifier id, const std::string& filename, JobSystem& jobs)
+{
+	assert(!isLoaded(id) && !isLoading(id));
+
+	std::shared_ptr<PendingLoad> load(new PendingLoad());
+	load->id = id;
+	load->filename = filename;
+
+	// The task shares the load, so the holder may be destroyed before the worker is done
+	mPendingLoads.push_back(load);
+	load->task = jobs.run(std::bind(&ResourceHolder::decode, load));
+}
+
+template <typename Resource, typename Identifier>
+void ResourceHolder<Resource, Identifier>::updateLoading()
+{
+	for (auto itr = mPendingLoads.begin(); itr != mPendingLoads.end(); )
+	{
+		PendingLoad& load = **itr;
+		if (!load.task.isDone())
+		{
+			++itr;
+			continue;
+		}
+
+		finishLoad(load);
+		itr = mPendingLoads.erase(itr);
+	}
+}
+
+template <typename Resource, typename Identifier>
+void ResourceHolder<Resource, Identifier>::finishLoading()
+{
+	for (;;)
+	{
+		updateLoading();
+		if (mPendingLoads.empty())
+			break;
+
+		sf::sleep(sf::milliseconds(1));
+	}
+}
+
+template <typename Resource, typename Identifier>
+Resource& ResourceHolder<Resource, Identifier>::acquire(Identifier id, const std::string& filename)
+{
+	if (isLoading(id))
+		waitForLoad(id);
+
+	if (!isLoaded(id))
+		load(id, filename);
+
+	assert(mResourceMap.find(id)->second->filename == filename);
+	return acquire(id);
+}
+
+template <typename Resource, typename Identifier>
+void ResourceHolder<Resource, Identifier>::finishLoad(PendingLoad& load)
+{
+	// Failures surface here, on the thread that asked for the resource
+	std::unique_ptr<Resource> resource;
+	if (load.decoded)
+		resource = AsyncLoading<Resource>::finish(std::move(load.decoded));
+
+	if (!resource)
+		throw std::runtime_error("ResourceHolder::finishLoad - Failed to load " + load.filename);
+
+	insertResource(load.id, load.filename, std::move(resource));
+}
+
+template <typename Resource, typename Identifier>
+void ResourceHolder<Resource, Identifier>::waitForLoad(Identifier id)
+{
+	// Only this resource; the other loads keep running in the background
+	auto itr = mPendingLoads.begin();
+	while ((*itr)->id != id)
+		++itr;
+
+	while (!(*itr)->task.isDone())
+		sf::sleep(sf::milliseconds(1));
+
+	finishLoad(**itr);
+	mPendingLoads.erase(itr);
+}
+
+template <typename Resource, typename Identifier>
+Resource& ResourceHolder<Resource, Identifier>::acquire(Identifier id)
+{
+	auto found = mResourceMap.find(id);
+	assert(found != mResourceMap.end());
+
+	++found->second->references;
+	return *found->second->resource;
+}
+
+template <typename Resource, typename Identifier>
+void ResourceHolder<Resource, Identifier>::release(Identifier id)
+{
+	auto found = mResourceMap.find(id);
+	assert(found != mResourceMap.end() && found->second->references > 0);
+
+	if (--found->second->references == 0 && mRetained.count(id) == 0)
+		mResourceMap.erase(found);
+}
+
+template <typename Resource, typename Identifier>
+void ResourceHolder<Resource, Identifier>::setRetained(Identifier id, bool retained)
+{
+	// Takes effect with the next release, so it may be set before the resource is loaded
+	if (retained)
+		mRetained.insert(id);
+	else
+		mRetained.erase(id);
+}
+
+template <typename Resource, typename Identifier>
+void ResourceHolder<Resource, Identifier>::insert(Identifier id, const std::string& key, std::unique_ptr<Resource> resource)
+{
+	insertResource(id, key, std::move(resource));
+}
+
+template <typename Resource, typename Identifier>
+bool ResourceHolder<Resource, Identifier>::isLoaded(Identifier id) const
+{
+	return mResourceMap.find(id) != mResourceMap.end();
+}
+
+template <typename Resource, typename Identifier>
+bool ResourceHolder<Resource, Identifier>::isLoading(Identifier id) const
+{
+	for (auto itr = mPendingLoads.begin(); itr != mPendingLoads.end(); ++itr)
+	{
+		if ((*itr)->id == id)
+			return true;
+	}
+
+	return false;
 }
 
 template <typename Resource, typename Identifier>
@@ -62,7 +329,7 @@ Resource& ResourceHolder<Resource, Identifier>::get(Identifier id)
 	auto found = mResourceMap.find(id);
 	assert(found != mResourceMap.end());
 
-	return *found->second;
+	return *found->second->resource;
 }
 
 template <typename Resource, typename Identifier>
@@ -71,16 +338,79 @@ const Resource& ResourceHolder<Resource, Identifier>::get(Identifier id) const
 	auto found = mResourceMap.find(id);
 	assert(found != mResourceMap.end());
 
-	return *found->second;
+	return *found->second->resource;
 }
 
 template <typename Resource, typename Identifier>
-void ResourceHolder<Resource, Identifier>::insertResource(Identifier id, std::unique_ptr<Resource> resource) 
+void ResourceHolder<Resource, Identifier>::insertResource(Identifier id, const std::string& filename, std::unique_ptr<Resource> resource) 
 {
+	std::unique_ptr<Entry> entry(new Entry());
+	entry->resource = std::move(resource);
+	entry->filename = filename;
+	entry->references = 0;
+
 	// Insert and check success
-	auto inserted = mResourceMap.insert(std::make_pair(id, std::move(resource)));
+	auto inserted = mResourceMap.insert(std::make_pair(id, std::move(entry)));
 	assert(inserted.second);
 }
 
+template <typename Resource, typename Identifier>
+void ResourceHolder<Resource, Identifier>::decode(std::shared_ptr<PendingLoad> load)
+{
+	// Runs on a worker thread; only touches the load's own members
+	std::unique_ptr<Decoded> decoded(new Decoded());
+	if (AsyncLoading<Resource>::decode(*decoded, load->filename))
+		load->decoded = std::move(decoded);
+}
+
+
+template <typename Resource, typename Identifier>
+ResourceReference<Resource, Identifier>::ResourceReference()
+: mHolder(nullptr)
+, mId()
+{
+}
+
+template <typename Resource, typename Identifier>
+ResourceReference<Resource, Identifier>::~ResourceReference()
+{
+	reset();
+}
+
+template <typename Resource, typename Identifier>
+Resource& ResourceReference<Resource, Identifier>::acquire(Holder& holder, Identifier id, const std::string& filename)
+{
+	reset();
+
+	// Only remember the reference once the holder counted it
+	Resource& resource = holder.acquire(id, filename);
+	mHolder = &holder;
+	mId = id;
+
+	return resource;
+}
+
+template <typename Resource, typename Identifier>
+Resource& ResourceReference<Resource, Identifier>::acquire(Holder& holder, Identifier id)
+{
+	reset();
+
+	Resource& resource = holder.acquire(id);
+	mHolder = &holder;
+	mId = id;
+
+	return resource;
+}
+
+template <typename Resource, typename Identifier>
+void ResourceReference<Resource, Identifier>::reset()
+{
+	if (!mHolder)
+		return;
+
+	mHolder->release(mId);
+	mHolder = nullptr;
+}
+
 
 #endif
\ No newline at end of file
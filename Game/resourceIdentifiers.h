@@ -6,6 +6,7 @@
 namespace sf
 {
 	class Texture;
+	class Image;
 	class Font;
 }
 
@@ -35,11 +36,35 @@ namespace Fonts
 	};
 }
 
+namespace Atlases
+{
+	enum ID
+	{
+		Sprites,
+	};
+}
+
 // Forward declaration and a few type definitions
 template <typename Resource, typename Identifier>
 class ResourceHolder;
 
+template <typename Resource, typename Identifier>
+class ResourceReference;
+
 typedef ResourceHolder<sf::Texture, Textures::ID> TextureHolder;
 typedef ResourceHolder<sf::Font, Fonts::ID>			FontHolder;
 
+// Decoded images, not yet on the GPU; the source of the texture atlas
+typedef ResourceHolder<sf::Image, Textures::ID>		ImageHolder;
+
+// Small sprite textures are packed into an atlas instead
+class TextureAtlas;
+
+typedef ResourceHolder<TextureAtlas, Atlases::ID>	AtlasHolder;
+
+// References that release what they acquired when they go
+typedef ResourceReference<sf::Texture, Textures::ID>	TextureReference;
+typedef ResourceReference<sf::Image, Textures::ID>		ImageReference;
+typedef ResourceReference<TextureAtlas, Atlases::ID>	AtlasReference;
+
 #endif
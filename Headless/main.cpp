@@ -0,0 +1,70 @@
+// Runs the game simulation without window, GL context or frame limit.
+// Usage: Headless [ticks] or Headless --replay <file>; run it from the directory containing the game's assets.
+
+#include "World.h"
+#include "Animal.h"
+#include "Player.h"
+#include "CommandQueue.h"
+
+#include <SFML/System/Clock.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+
+namespace
+{
+	// Same view and time step as the game
+	const sf::Vector2f	ViewSize(1000.f, 700.f);
+	const sf::Time		TimePerFrame = sf::seconds(1.f/60.f);
+	const sf::Uint64	Seed = 20130901;
+}
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		bool replay = (argc > 2 && std::string(argv[1]) == "--replay");
+		int maxTicks = (argc > 1 && !replay) ? std::atoi(argv[1]) : 10000;
+
+		Player player;
+		if (replay && !player.replayFrom(argv[2]))
+			throw std::runtime_error("Failed to load replay " + std::string(argv[2]));
+
+		// Nothing is prefetched, the world loads its images itself
+		AssetCache assets;
+		World world(ViewSize, nullptr, assets, player.startMission(Seed), nullptr);
+
+		// Without replay, the player keeps firing, so projectiles and collisions are exercised as well
+		Command fire;
+		fire.category = Category::PlayerAnimal;
+		fire.action = derivedAction<Animal>([] (Animal& animal, sf::Time)
+		{
+			animal.fire();
+		});
+
+		sf::Clock clock;
+		int tick = 0;
+		for (; (replay ? !player.isReplayFinished() : tick < maxTicks) && world.hasAlivePlayer() && !world.hasPlayerReachedEnd(); ++tick)
+		{
+			if (replay)
+				player.pushCommands(world.getCommandQueue());
+			else
+				world.getCommandQueue().push(fire);
+
+			world.update(TimePerFrame);
+		}
+
+		sf::Time elapsed = clock.getElapsedTime();
+		std::cout << "Ticks: " << tick << ", player " << (world.hasAlivePlayer() ? "alive" : "dead") << std::endl;
+		std::cout << "Elapsed: " << elapsed.asMilliseconds() << " ms, " << elapsed.asMicroseconds() / std::max(tick, 1) << " us per tick" << std::endl;
+	}
+	catch (std::exception& e)
+	{
+		std::cout << "\nEXCEPTION: " << e.what() << std::endl;
+		return 1;
+	}
+}